@@ -2,8 +2,12 @@
 #include <raylib.h>
 #include <math.h>
 #include <raymath.h>
+#include <rlgl.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <sys/stat.h>
 
 #define WINDOW_WIDTH 1000
 #define WINDOW_HEIGHT 1000
@@ -12,6 +16,37 @@
 #define INPUT_FIELD_WIDTH 80
 #define INPUT_FIELD_HEIGHT 40
 
+#define FORM_LABEL_COUNT 9
+#define FORM_INPUT_COUNT 3
+
+// input recording
+#define MAX_FRAME_CHARS 16
+#define RECORDING_MAGIC "DMIR"
+#define RECORDING_VERSION 1
+#define RECORDING_FPS 60
+
+// a state regresses when its p50 or p90 is this much slower than the baseline
+#define REPLAY_TOLERANCE 0.10
+
+// thumbnail atlas
+#define MATRIX_KEY_COUNT (22 * 12 * 22)
+#define THUMBNAIL_SIZE 256
+#define ATLAS_PAGE_SIZE 2048
+#define ATLAS_COLUMNS (ATLAS_PAGE_SIZE / THUMBNAIL_SIZE)
+#define ATLAS_THUMBNAILS_PER_PAGE (ATLAS_COLUMNS * ATLAS_COLUMNS)
+#define ATLAS_MAX_PAGES ((MATRIX_KEY_COUNT + ATLAS_THUMBNAILS_PER_PAGE - 1) / ATLAS_THUMBNAILS_PER_PAGE)
+#define ATLAS_DIRECTORY "./cache"
+#define ATLAS_INDEX_FILE "matrix_atlas.idx"
+#define ATLAS_PAGE_FILE "matrix_atlas_%02d.rgb"
+#define ATLAS_MAGIC "DMAX"
+#define ATLAS_VERSION 2
+// pages are raw RGB8 rows, so a single tile can be read without decoding the page
+#define ATLAS_PAGE_STRIDE (ATLAS_PAGE_SIZE * 3)
+#define ATLAS_PAGE_BYTES ((long)ATLAS_PAGE_STRIDE * ATLAS_PAGE_SIZE)
+
+// partial-date queries
+#define MATRIX_FIELD_COUNT 29
+
 // octagon
 #define OCTAGON_SIDES 8
 #define OCTAGON_RADIUS 450.0f
@@ -51,13 +86,60 @@
 // secondary
 #define CIRCLE_THICKNESS 3.0f
 
+#define MATRIX_CIRCLE_COUNT 29
+
+// --------------------------------------
+
+// lines
+#define MATRIX_LINE_COUNT 8
+#define MATRIX_LINE_THICKNESS 2.0f
+
+#define DASH_LENGTH 10.0f
+#define DASH_GAP 5.0f
+#define DASH_THICKNESS 2.0f
+
+// --------------------------------------
+
+// text
+#define TEXT_SPACING 2.0f
+#define LABEL_FONT_SIZE 15.0f
+#define NUMBER_FONT_SIZE 24.0f
+#define DATE_FONT_SIZE 20.0f
+
+#define MATRIX_LABEL_COUNT 2
+#define MATRIX_NUMBER_COUNT 29
+
+// share of the font size above the baseline, used by the vector export
+#define EXPORT_TEXT_ASCENT 0.8f
+
 //----------------------------------------
 
 typedef enum {
     STATE_INPUT_FORM,
-    STATE_MATRIX_VIEW
+    STATE_MATRIX_VIEW,
+    APP_STATE_COUNT
 } AppState;
 
+const char* app_state_names[APP_STATE_COUNT] = {"input_form", "matrix_view"};
+
+typedef enum {
+    INPUT_KEY_ENTER = 1 << 0,
+    INPUT_KEY_ESCAPE = 1 << 1,
+    INPUT_KEY_BACKSPACE = 1 << 2,
+    INPUT_MOUSE_LEFT = 1 << 3,
+    INPUT_MOUSE_RIGHT = 1 << 4,
+    INPUT_MOUSE_MIDDLE = 1 << 5
+} InputFlags;
+
+// everything the app reads from raylib in one frame, so it can be recorded and replayed
+typedef struct {
+    double time;
+    Vector2 mouse_position;
+    unsigned char pressed;
+    int char_count;
+    int chars[MAX_FRAME_CHARS];
+} FrameInput;
+
 typedef struct {
     Font font;
     Vector2 position;
@@ -75,6 +157,30 @@ typedef struct {
     bool is_valid;
 } DateOfBirth;
 
+typedef struct {
+    Vector2 position;
+    float radius;
+    float inner_radius;
+    float outer_radius;
+    Color ring_color;
+} RingedCircle;
+
+typedef struct {
+    Vector2 end;
+    Color color;
+} MatrixLine;
+
+typedef struct {
+    const char* text;
+    Vector2 position;
+    float rotation;
+} MatrixLabel;
+
+typedef struct {
+    int value;
+    Vector2 position;
+} MatrixNumber;
+
 typedef struct {
     char text[MAX_INPUT_CHARS + 1];
     Rectangle box;
@@ -84,6 +190,97 @@ typedef struct {
     int max_length;
 } InputField;
 
+typedef struct {
+    const char* text;
+    Vector2 position;
+    float font_size;
+    Color color;
+} FormLabel;
+
+// input widget, remembers the state it was last painted with
+typedef struct {
+    InputField* field;
+    const char* placeholder;
+    float text_width;
+    char drawn_text[MAX_INPUT_CHARS + 1];
+    bool drawn_mouse_on_text;
+    bool drawn_active;
+    bool drawn_caret;
+    bool dirty;
+} FormInput;
+
+typedef struct {
+    char text[100];
+    Color color;
+    bool visible;
+    Vector2 position;
+    Rectangle bounds;
+    bool dirty;
+} FormResult;
+
+typedef struct {
+    long draw_calls;
+    long measure_calls;
+} FormStats;
+
+typedef struct {
+    RenderTexture2D target;
+    Color background;
+    FormLabel labels[FORM_LABEL_COUNT];
+    FormInput inputs[FORM_INPUT_COUNT];
+    FormResult result;
+    bool labels_dirty;
+    FormStats stats;
+    FormStats totals;
+    long frames;
+} InputForm;
+
+typedef struct {
+    AppState state;
+    DateOfBirth dob;
+    InputField day_field;
+    InputField month_field;
+    InputField year_field;
+    bool show_result;
+    char result_text[100];
+    Color result_color;
+    InputForm form;
+    Vector2 center;
+    Font font;
+} App;
+
+typedef struct {
+    FILE* file;
+    int fps;
+    long frames;
+    bool failed;
+} InputRecording;
+
+typedef struct {
+    double* samples;
+    int count;
+    int capacity;
+} FrameTimes;
+
+typedef struct {
+    char magic[4];
+    unsigned int layout_hash;
+    unsigned int page_count;
+} AtlasHeader;
+
+typedef struct {
+    short slots[MATRIX_KEY_COUNT];
+    int page_count;
+    char directory[256];
+} MatrixAtlas;
+
+typedef struct {
+    int frames;
+    double p50;
+    double p90;
+    double p99;
+} ReplaySummary;
+
 //----------------------------------------
 
 // circles inner/outer radius 
@@ -111,6 +308,12 @@ const float outer_radius_core_circle = 300.0f + 2.5f / 2;
 const Vector2 p1 = {800, 500};
 const Vector2 p2 = {500, 800};
 
+// generation lines text
+const MatrixLabel matrix_labels[MATRIX_LABEL_COUNT] = {
+    {"female generation line", {530, 430}, -44.0f},
+    {"male generation line", {330, 300}, 44.0f}
+};
+
 //----------------------------------------
 
 void init_input_field(InputField* field, Rectangle box, int max_length) {
@@ -122,32 +325,51 @@ void init_input_field(InputField* field, Rectangle box, int max_length) {
     field->max_length = max_length;
 }
 
-void update_input_field(InputField* field) {
-    if (CheckCollisionPointRec(GetMousePosition(), field->box)) {
+void poll_frame_input(FrameInput* input, double time) {
+    input->time = time;
+    input->mouse_position = GetMousePosition();
+    input->pressed = 0;
+    if (IsKeyPressed(KEY_ENTER)) input->pressed |= INPUT_KEY_ENTER;
+    if (IsKeyPressed(KEY_ESCAPE)) input->pressed |= INPUT_KEY_ESCAPE;
+    if (IsKeyPressed(KEY_BACKSPACE)) input->pressed |= INPUT_KEY_BACKSPACE;
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) input->pressed |= INPUT_MOUSE_LEFT;
+    if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT)) input->pressed |= INPUT_MOUSE_RIGHT;
+    if (IsMouseButtonPressed(MOUSE_BUTTON_MIDDLE)) input->pressed |= INPUT_MOUSE_MIDDLE;
+
+    input->char_count = 0;
+    int key = GetCharPressed();
+    while (key > 0) {
+        if (input->char_count < MAX_FRAME_CHARS) input->chars[input->char_count++] = key;
+        key = GetCharPressed();
+    }
+}
+
+// the active field consumes the chars of the frame, like GetCharPressed() does
+void update_input_field(InputField* field, FrameInput* input) {
+    if (CheckCollisionPointRec(input->mouse_position, field->box)) {
         field->mouse_on_text = true;
-        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+        if (input->pressed & INPUT_MOUSE_LEFT) {
             field->active = true;
         }
     } else {
         field->mouse_on_text = false;
-        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+        if (input->pressed & INPUT_MOUSE_LEFT) {
             field->active = false;
         }
     }
 
     if (field->active) {
-        int key = GetCharPressed();
-
-        while (key > 0) {
+        for (int i = 0; i < input->char_count; i++) {
+            int key = input->chars[i];
             if ((key >= 48) && (key <= 57) && (field->letter_count < field->max_length)) {
                 field->text[field->letter_count] = (char)key;
                 field->text[field->letter_count + 1] = '\0';
                 field->letter_count++;
             }
-            key = GetCharPressed();
         }
+        input->char_count = 0;
 
-        if (IsKeyPressed(KEY_BACKSPACE)) {
+        if (input->pressed & INPUT_KEY_BACKSPACE) {
             field->letter_count--;
             if (field->letter_count < 0) field->letter_count = 0;
             field->text[field->letter_count] = '\0';
@@ -155,7 +377,10 @@ void update_input_field(InputField* field) {
     }
 }
 
-void draw_input_field(InputField* field, Font font, const char* placeholder) {
+// returns the number of draw calls issued
+int draw_input_field(InputField* field, Font font, const char* placeholder, bool caret_visible, float text_width) {
+    int draw_calls = 2;
+
     // border color
     Color border_color = LIGHTGRAY;
     if (field->mouse_on_text) border_color = DARKBLUE;
@@ -168,32 +393,35 @@ void draw_input_field(InputField* field, Font font, const char* placeholder) {
     // draw text or placeholder
     if (field->letter_count > 0) {
         DrawTextEx(font, field->text, (Vector2){field->box.x + 10, field->box.y + 10}, 20, 2, BLACK);
+        draw_calls++;
     } else if (!field->active) {
         DrawTextEx(font, placeholder, (Vector2){field->box.x + 10, field->box.y + 10}, 16, 2, LIGHTGRAY);
+        draw_calls++;
     }
 
-    if (field->active) {
-        if (((GetTime() * 2) - (int)(GetTime() * 2)) > 0.5f) {
-            Vector2 text_size = MeasureTextEx(font, field->text, 20, 2);
-            DrawTextEx(font, "_", (Vector2){field->box.x +10 + text_size.x, field->box.y + 10}, 20, 2, BLACK);
-        }
+    if (caret_visible) {
+        DrawTextEx(font, "_", (Vector2){field->box.x +10 + text_width, field->box.y + 10}, 20, 2, BLACK);
+        draw_calls++;
     }
 
+    return draw_calls;
+}
+
+int days_in_month(int month, bool leap) {
+    const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && leap) ? 29 : days[month - 1];
+}
+
+bool is_leap_year(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
 }
 
 bool is_valid_date(int day, int month, int year) {
     if (year < 1900 || year > 2025) return false;
     if (month < 1 || month > 12) return false;
     if (day < 1) return false;
-    
-    int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    
-    // control leap year
-    if (month == 2 && ((year % 4 == 0 && year % 100 != 0) || (year % 400 == 0))) {
-        days_in_month[1] = 29;
-    }
-    
-    return day <= days_in_month[month - 1];
+
+    return day <= days_in_month(month, is_leap_year(year));
 }
 
 // struct to contain destiny matrix numbers 
@@ -238,6 +466,70 @@ typedef struct {
     int center_bottom;
 } DestinyMatrix;
 
+typedef struct {
+    const char* name;
+    size_t offset;
+} MatrixField;
+
+// every DestinyMatrix field, for per-field statistics
+const MatrixField matrix_fields[MATRIX_FIELD_COUNT] = {
+    {"big_left", offsetof(DestinyMatrix, big_left)},
+    {"big_top_left", offsetof(DestinyMatrix, big_top_left)},
+    {"big_top", offsetof(DestinyMatrix, big_top)},
+    {"big_top_right", offsetof(DestinyMatrix, big_top_right)},
+    {"big_right", offsetof(DestinyMatrix, big_right)},
+    {"big_bottom_right", offsetof(DestinyMatrix, big_bottom_right)},
+    {"big_bottom", offsetof(DestinyMatrix, big_bottom)},
+    {"big_bottom_left", offsetof(DestinyMatrix, big_bottom_left)},
+    {"center", offsetof(DestinyMatrix, center)},
+    {"center_right", offsetof(DestinyMatrix, center_right)},
+    {"medium_left", offsetof(DestinyMatrix, medium_left)},
+    {"medium_top_left", offsetof(DestinyMatrix, medium_top_left)},
+    {"medium_top", offsetof(DestinyMatrix, medium_top)},
+    {"medium_top_right", offsetof(DestinyMatrix, medium_top_right)},
+    {"medium_right", offsetof(DestinyMatrix, medium_right)},
+    {"medium_bottom_right", offsetof(DestinyMatrix, medium_bottom_right)},
+    {"medium_bottom", offsetof(DestinyMatrix, medium_bottom)},
+    {"medium_bottom_left", offsetof(DestinyMatrix, medium_bottom_left)},
+    {"small_left", offsetof(DestinyMatrix, small_left)},
+    {"small_top_left", offsetof(DestinyMatrix, small_top_left)},
+    {"small_top", offsetof(DestinyMatrix, small_top)},
+    {"small_top_right", offsetof(DestinyMatrix, small_top_right)},
+    {"small_right", offsetof(DestinyMatrix, small_right)},
+    {"small_bottom_right", offsetof(DestinyMatrix, small_bottom_right)},
+    {"small_bottom", offsetof(DestinyMatrix, small_bottom)},
+    {"small_bottom_left", offsetof(DestinyMatrix, small_bottom_left)},
+    {"money", offsetof(DestinyMatrix, money)},
+    {"love", offsetof(DestinyMatrix, love)},
+    {"center_bottom", offsetof(DestinyMatrix, center_bottom)}
+};
+
+// catches a field added to DestinyMatrix but not to matrix_fields
+_Static_assert(sizeof(DestinyMatrix) == MATRIX_FIELD_COUNT * sizeof(int), "matrix_fields must list every DestinyMatrix field");
+
+int matrix_field_value(const DestinyMatrix* matrix, int field) {
+    return *(const int*)((const char*)matrix + matrix_fields[field].offset);
+}
+
+typedef struct {
+    int day;
+    int month;
+    int year;
+} PartialDate;
+
+typedef struct {
+    int day_counts[32][23];
+    int year_counts[2][23];
+    DestinyMatrix matrices[MATRIX_KEY_COUNT];
+} DateQueryTables;
+
+typedef struct {
+    long total;
+    int distinct;
+    int keys[MATRIX_KEY_COUNT];
+    long counts[MATRIX_KEY_COUNT];
+} DateQueryResult;
+
 int reduce_to_destiny_number(int number) {
     while (number > 22) {
         int temp = 0; 
@@ -250,21 +542,22 @@ int reduce_to_destiny_number(int number) {
     return (number == 0) ? 22 : number;
 }
 
-DestinyMatrix calculate_destiny_matrix(DateOfBirth dob) {
+int year_digit_sum(int year) {
+    int y1 = (year / 1000) % 10;
+    int y2 = (year / 100) % 10;
+    int y3 = (year / 10) % 10;
+    int y4 = year % 10;
+
+    return y1 + y2 + y3 + y4;
+}
+
+// the whole matrix follows from the three reduced date numbers
+DestinyMatrix calculate_destiny_matrix_from_numbers(int day_number, int month_number, int year_number) {
     DestinyMatrix matrix = {0};
-    
-    int y1 = (dob.year / 1000) % 10;
-    int y2 = (dob.year / 100) % 10;
-    int y3 = (dob.year / 10) % 10;
-    int y4 = dob.year % 10;
-    
-    int day_sum = dob.day;
-    int month_sum = dob.month;
-    int year_sum = y1 + y2 + y3 + y4;
 
-    matrix.big_left = reduce_to_destiny_number(day_sum);
-    matrix.big_top = reduce_to_destiny_number(month_sum);
-    matrix.big_right = reduce_to_destiny_number(year_sum);
+    matrix.big_left = day_number;
+    matrix.big_top = month_number;
+    matrix.big_right = year_number;
     matrix.big_bottom = reduce_to_destiny_number(matrix.big_left + matrix.big_top + matrix.big_right);
 
     matrix.center = reduce_to_destiny_number(matrix.big_left + matrix.big_top + matrix.big_right + matrix.big_bottom);
@@ -303,6 +596,16 @@ DestinyMatrix calculate_destiny_matrix(DateOfBirth dob) {
     return matrix;
 }
 
+DestinyMatrix calculate_destiny_matrix(DateOfBirth dob) {
+    int day_sum = dob.day;
+    int month_sum = dob.month;
+    int year_sum = year_digit_sum(dob.year);
+
+    return calculate_destiny_matrix_from_numbers(reduce_to_destiny_number(day_sum),
+                                                 reduce_to_destiny_number(month_sum),
+                                                 reduce_to_destiny_number(year_sum));
+}
+
 //draw functions
 void draw_matrix_octagon(Vector2 center) {
     DrawPolyLinesEx(center, OCTAGON_SIDES, OCTAGON_RADIUS, OCTAGON_ROTATION, OCTAGON_THICKNESS, BLACK);
@@ -334,97 +637,94 @@ void draw_ringed_circle(Vector2 position, float radius, float inner_radius, floa
     DrawRing(position, inner_radius, outer_radius, 0, 360, 64, ring_color);
 }
 
-void draw_matrix_circles(Vector2 center) {
-    int screen_width = GetScreenWidth();
-    int screen_height = GetScreenHeight();
+void get_matrix_circles(Vector2 center, float screen_width, float screen_height, RingedCircle circles[MATRIX_CIRCLE_COUNT]) {
+    int i = 0;
 
     // top
-    draw_ringed_circle((Vector2){center.x, screen_height * 0.20f}, SMALL_CIRCLE_RADIUS, inner_radius_small, outer_radius_small, LIGHTGRAY);
-    draw_ringed_circle((Vector2){center.x, screen_height * 0.14f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium, outer_radius_medium, DARKBLUE);
-    draw_ringed_circle((Vector2){center.x, screen_height * 0.07f}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, GRAY);
+    circles[i++] = (RingedCircle){{center.x, screen_height * 0.20f}, SMALL_CIRCLE_RADIUS, inner_radius_small, outer_radius_small, LIGHTGRAY};
+    circles[i++] = (RingedCircle){{center.x, screen_height * 0.14f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium, outer_radius_medium, DARKBLUE};
+    circles[i++] = (RingedCircle){{center.x, screen_height * 0.07f}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, GRAY};
 
     // top-right
-    draw_ringed_circle((Vector2){screen_width * 0.71f, screen_height * 0.29f - 5.0f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.74f + 15.0f, screen_height * 0.26f - 15.0f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium_other, outer_radius_medium_other, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.80f + 10.0f, screen_height * 0.20f - 10.0f}, BIG_CIRCLE_RADIUS, inner_radius_big_other, outer_radius_big_other, BLACK);
+    circles[i++] = (RingedCircle){{screen_width * 0.71f, screen_height * 0.29f - 5.0f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.74f + 15.0f, screen_height * 0.26f - 15.0f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium_other, outer_radius_medium_other, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.80f + 10.0f, screen_height * 0.20f - 10.0f}, BIG_CIRCLE_RADIUS, inner_radius_big_other, outer_radius_big_other, BLACK};
 
     // right
-    draw_ringed_circle((Vector2){screen_width * 0.80f, screen_height * 0.50f}, SMALL_CIRCLE_RADIUS, inner_radius_small, outer_radius_small, ORANGE);
-    draw_ringed_circle((Vector2){screen_width * 0.86f, screen_height * 0.50f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium, outer_radius_medium, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.93f + 2.0f, screen_height * 0.50f}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, RED);
+    circles[i++] = (RingedCircle){{screen_width * 0.80f, screen_height * 0.50f}, SMALL_CIRCLE_RADIUS, inner_radius_small, outer_radius_small, ORANGE};
+    circles[i++] = (RingedCircle){{screen_width * 0.86f, screen_height * 0.50f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium, outer_radius_medium, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.93f + 2.0f, screen_height * 0.50f}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, RED};
 
     // bottom-right
-    draw_ringed_circle((Vector2){screen_width * 0.71f, screen_height * 0.71f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.75f + 4.0f, screen_height * 0.75f + 4.0f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium_other, outer_radius_medium_other, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.80f + 8.0f, screen_height * 0.80f + 8.0f}, BIG_CIRCLE_RADIUS, inner_radius_big_other, outer_radius_big_other, BLACK);
+    circles[i++] = (RingedCircle){{screen_width * 0.71f, screen_height * 0.71f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.75f + 4.0f, screen_height * 0.75f + 4.0f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium_other, outer_radius_medium_other, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.80f + 8.0f, screen_height * 0.80f + 8.0f}, BIG_CIRCLE_RADIUS, inner_radius_big_other, outer_radius_big_other, BLACK};
 
     // bottom
-    draw_ringed_circle((Vector2){center.x, screen_height * 0.80f}, SMALL_CIRCLE_RADIUS, inner_radius_small, outer_radius_small, ORANGE);
-    draw_ringed_circle((Vector2){center.x, screen_height * 0.86f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium, outer_radius_medium, BLACK);
-    draw_ringed_circle((Vector2){center.x, screen_height * 0.93f}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, RED);
+    circles[i++] = (RingedCircle){{center.x, screen_height * 0.80f}, SMALL_CIRCLE_RADIUS, inner_radius_small, outer_radius_small, ORANGE};
+    circles[i++] = (RingedCircle){{center.x, screen_height * 0.86f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium, outer_radius_medium, BLACK};
+    circles[i++] = (RingedCircle){{center.x, screen_height * 0.93f}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, RED};
 
     // bottom-left
-    draw_ringed_circle((Vector2){screen_width * 0.29f, screen_height * 0.71f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.25f - 4.0f, screen_height * 0.75f + 4.0f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium_other, outer_radius_medium_other, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.20f - 8.0f, screen_height * 0.80f + 8.0f}, BIG_CIRCLE_RADIUS, inner_radius_big_other, outer_radius_big_other, BLACK);
+    circles[i++] = (RingedCircle){{screen_width * 0.29f, screen_height * 0.71f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.25f - 4.0f, screen_height * 0.75f + 4.0f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium_other, outer_radius_medium_other, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.20f - 8.0f, screen_height * 0.80f + 8.0f}, BIG_CIRCLE_RADIUS, inner_radius_big_other, outer_radius_big_other, BLACK};
 
     // left
-    draw_ringed_circle((Vector2){screen_width * 0.20f, screen_height * 0.50f}, SMALL_CIRCLE_RADIUS, inner_radius_small, outer_radius_small, LIGHTGRAY);
-    draw_ringed_circle((Vector2){screen_width * 0.14f, screen_height * 0.50f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium, outer_radius_medium, DARKBLUE);
-    draw_ringed_circle((Vector2){screen_width * 0.07f, screen_height * 0.50f}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, GRAY);
+    circles[i++] = (RingedCircle){{screen_width * 0.20f, screen_height * 0.50f}, SMALL_CIRCLE_RADIUS, inner_radius_small, outer_radius_small, LIGHTGRAY};
+    circles[i++] = (RingedCircle){{screen_width * 0.14f, screen_height * 0.50f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium, outer_radius_medium, DARKBLUE};
+    circles[i++] = (RingedCircle){{screen_width * 0.07f, screen_height * 0.50f}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, GRAY};
 
     // top-left
-    draw_ringed_circle((Vector2){screen_width * 0.29f, screen_height * 0.29f - 5.0f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.24f + 3.0f, screen_height * 0.26f - 15.0f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium_other, outer_radius_medium_other, BLACK);
-    draw_ringed_circle((Vector2){screen_width * 0.18f + 10.0f, screen_height * 0.20f - 10.0f}, BIG_CIRCLE_RADIUS, inner_radius_big_other, outer_radius_big_other, BLACK);
+    circles[i++] = (RingedCircle){{screen_width * 0.29f, screen_height * 0.29f - 5.0f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.24f + 3.0f, screen_height * 0.26f - 15.0f}, MEDIUM_CIRCLE_RADIUS, inner_radius_medium_other, outer_radius_medium_other, BLACK};
+    circles[i++] = (RingedCircle){{screen_width * 0.18f + 10.0f, screen_height * 0.20f - 10.0f}, BIG_CIRCLE_RADIUS, inner_radius_big_other, outer_radius_big_other, BLACK};
 
     // core
-    draw_ringed_circle((Vector2){center.x, center.y}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, PURPLE);
+    circles[i++] = (RingedCircle){{center.x, center.y}, BIG_CIRCLE_RADIUS, inner_radius_big, outer_radius_big, PURPLE};
 
     // other
-    draw_ringed_circle((Vector2){screen_width * 0.73f, screen_height * 0.57f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK); // money
-    draw_ringed_circle((Vector2){screen_width * 0.57f, screen_height * 0.73f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK); // love
-    draw_ringed_circle((Vector2){screen_width * 0.65f, screen_height * 0.65f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK); // center-bottom
-    draw_ringed_circle((Vector2){screen_width * 0.57f, screen_height * 0.50f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK); // center-right
-}   
+    circles[i++] = (RingedCircle){{screen_width * 0.73f, screen_height * 0.57f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK}; // money
+    circles[i++] = (RingedCircle){{screen_width * 0.57f, screen_height * 0.73f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK}; // love
+    circles[i++] = (RingedCircle){{screen_width * 0.65f, screen_height * 0.65f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK}; // center-bottom
+    circles[i++] = (RingedCircle){{screen_width * 0.57f, screen_height * 0.50f}, SMALL_CIRCLE_RADIUS, inner_radius_small_other, outer_radius_small_other, BLACK}; // center-right
+}
 
-void draw_matrix_lines(Vector2 center) {
-    int screen_width = GetScreenWidth();
-    int screen_height = GetScreenHeight();
-    Vector2 start = {center.x, center.y};
-    const float thickness = 2.0f;
+void draw_matrix_circles(Vector2 center) {
+    RingedCircle circles[MATRIX_CIRCLE_COUNT];
+    get_matrix_circles(center, GetScreenWidth(), GetScreenHeight(), circles);
 
-    // top
-    Vector2 end_top = {center.x, 100.0f};
-    DrawLineEx(start, end_top, thickness, GRAY);
+    for (int i = 0; i < MATRIX_CIRCLE_COUNT; i++) {
+        draw_ringed_circle(circles[i].position, circles[i].radius, circles[i].inner_radius, circles[i].outer_radius, circles[i].ring_color);
+    }
+}
 
+void get_matrix_lines(Vector2 center, float screen_width, float screen_height, MatrixLine lines[MATRIX_LINE_COUNT]) {
+    // top
+    lines[0] = (MatrixLine){{center.x, 100.0f}, GRAY};
     // top-right
-    Vector2 end_top_right = {screen_width * 0.70f, screen_height * 0.30f};
-    DrawLineEx(start, end_top_right, thickness, BLACK);
-
+    lines[1] = (MatrixLine){{screen_width * 0.70f, screen_height * 0.30f}, BLACK};
     // right
-    Vector2 end_right = {screen_width * 0.80f, screen_height * 0.50f};
-    DrawLineEx(start, end_right, thickness, BLACK);
-
+    lines[2] = (MatrixLine){{screen_width * 0.80f, screen_height * 0.50f}, BLACK};
     // bottom-right
-    Vector2 end_bottom_right = {screen_width * 0.70f, screen_height * 0.70f};
-    DrawLineEx(start, end_bottom_right, thickness, BLACK);
-
+    lines[3] = (MatrixLine){{screen_width * 0.70f, screen_height * 0.70f}, BLACK};
     // bottom
-    Vector2 end_bottom = {screen_width * 0.50f, screen_height * 0.80f};
-    DrawLineEx(start, end_bottom, thickness, BLACK);
-
+    lines[4] = (MatrixLine){{screen_width * 0.50f, screen_height * 0.80f}, BLACK};
     // bottom-left
-    Vector2 end_bottom_left = {screen_width * 0.30f, screen_height * 0.70f};
-    DrawLineEx(start, end_bottom_left, thickness, BLACK);
-
+    lines[5] = (MatrixLine){{screen_width * 0.30f, screen_height * 0.70f}, BLACK};
     // left
-    Vector2 end_left = {screen_width * 0.10f, screen_height * 0.50f};
-    DrawLineEx(start, end_left, thickness, BLACK);
-
+    lines[6] = (MatrixLine){{screen_width * 0.10f, screen_height * 0.50f}, BLACK};
     // top-left
-    Vector2 end_top_left = {screen_width * 0.20f, screen_height * 0.20f};
-    DrawLineEx(start, end_top_left, thickness, BLACK);
+    lines[7] = (MatrixLine){{screen_width * 0.20f, screen_height * 0.20f}, BLACK};
+}
+
+void draw_matrix_lines(Vector2 center) {
+    MatrixLine lines[MATRIX_LINE_COUNT];
+    get_matrix_lines(center, GetScreenWidth(), GetScreenHeight(), lines);
+
+    for (int i = 0; i < MATRIX_LINE_COUNT; i++) {
+        DrawLineEx(center, lines[i].end, MATRIX_LINE_THICKNESS, lines[i].color);
+    }
 }
 
 void draw_dashed_line(Vector2 start, Vector2 end, float dash_length, float gap_length, float thickness, Color color) {
@@ -446,324 +746,1652 @@ void draw_dashed_line(Vector2 start, Vector2 end, float dash_length, float gap_l
 }
 
 void draw_text(Font font) {
-    Text female_text = {font, {530, 430}, {0, 0}, -44.0f, 15.0f, 2.0f, BLACK};
-    DrawTextPro(female_text.font, "female generation line", female_text.position, female_text.origin, female_text.rotation, female_text.font_size, female_text.spacing, female_text.color);
+    for (int i = 0; i < MATRIX_LABEL_COUNT; i++) {
+        Text label_text = {font, matrix_labels[i].position, {0, 0}, matrix_labels[i].rotation, LABEL_FONT_SIZE, TEXT_SPACING, BLACK};
+        DrawTextPro(label_text.font, matrix_labels[i].text, label_text.position, label_text.origin, label_text.rotation, label_text.font_size, label_text.spacing, label_text.color);
+    }
+}
+
+void get_matrix_numbers(DestinyMatrix matrix, float screen_width, float screen_height, MatrixNumber numbers[MATRIX_NUMBER_COUNT]) {
+    int offset = 8;
+    int i = 0;
+    Vector2 center = {screen_width / 2.0f, screen_height / 2.0f};
+
+    // central number
+    numbers[i++] = (MatrixNumber){matrix.center, {center.x - offset, center.y - offset}};
+
+    // -----------------------------------------------------
+    // 8 BIG
+    // left
+    numbers[i++] = (MatrixNumber){matrix.big_left, {screen_width * 0.07f - offset, screen_height * 0.50f - offset}};
+
+    // top-left
+    numbers[i++] = (MatrixNumber){matrix.big_top_left, {screen_width * 0.18f + 10.0f - offset, screen_height * 0.20f - 10.0f - offset}};
+
+    // top
+    numbers[i++] = (MatrixNumber){matrix.big_top, {center.x - offset, screen_height * 0.07f - offset}};
+
+    // top-right
+    numbers[i++] = (MatrixNumber){matrix.big_top_right, {screen_width * 0.80f + 10.0f - offset, screen_height * 0.20f - 10.0f - offset}};
+
+    // right
+    numbers[i++] = (MatrixNumber){matrix.big_right, {screen_width * 0.93f + 2.0f - offset, screen_height * 0.50f - offset}};
+
+    // bottom-right
+    numbers[i++] = (MatrixNumber){matrix.big_bottom_right, {screen_width * 0.80f + 8.0f - offset, screen_height * 0.80f + 8.0f- offset}};
+
+    // bottom
+    numbers[i++] = (MatrixNumber){matrix.big_bottom, {center.x - offset, screen_height * 0.93f - offset}};
+
+    // bottom-left
+    numbers[i++] = (MatrixNumber){matrix.big_bottom_left, {screen_width * 0.20f - 8.0f - offset, screen_height * 0.80f + 8.0f - offset}};
+
+    // -----------------------------------------------------
+    // 8 MEDIUM
+    // left
+    numbers[i++] = (MatrixNumber){matrix.medium_left, {screen_width * 0.14f - offset, screen_height * 0.50f - offset}};
+
+    // top-left
+    numbers[i++] = (MatrixNumber){matrix.medium_top_left, {screen_width * 0.24f + 3.0f - offset, screen_height * 0.26f - 15.0f - offset}};
+
+    // top
+    numbers[i++] = (MatrixNumber){matrix.medium_top, {center.x - offset, screen_height * 0.14f - offset}};
+
+    // top-right
+    numbers[i++] = (MatrixNumber){matrix.medium_top_right, {screen_width * 0.74f + 15.0f - offset, screen_height * 0.26f - 15.0f - offset}};
+
+    // right
+    numbers[i++] = (MatrixNumber){matrix.medium_right, {screen_width * 0.86f - offset, screen_height * 0.50f - offset}};
+
+    // bottom-right
+    numbers[i++] = (MatrixNumber){matrix.medium_bottom_right, {screen_width * 0.75f + 4.0f - offset, screen_height * 0.75f + 4.0f - offset}};
+
+    // bottom
+    numbers[i++] = (MatrixNumber){matrix.medium_bottom, {center.x - offset, screen_height * 0.86f - offset}};
+
+    // bottom-left
+    numbers[i++] = (MatrixNumber){matrix.medium_bottom_left, {screen_width * 0.25f - 4.0f - offset, screen_height * 0.75f + 4.0f - offset}};
+
+    // -----------------------------------------------------
+    // 8 SMALL
+    // left
+    numbers[i++] = (MatrixNumber){matrix.small_left, {screen_width * 0.20f - offset, screen_height * 0.50f - offset}};
+
+    // top-left
+    numbers[i++] = (MatrixNumber){matrix.small_top_left, {screen_width * 0.29f - offset, screen_height * 0.29f - 5.0f - offset}};
+
+    // top
+    numbers[i++] = (MatrixNumber){matrix.small_top, {center.x - offset, screen_height * 0.20f - offset}};
+
+    // top-right
+    numbers[i++] = (MatrixNumber){matrix.small_top_right, {screen_width * 0.71f - offset, screen_height * 0.29f - 5.0f - offset}};
+
+    // right
+    numbers[i++] = (MatrixNumber){matrix.small_right, {screen_width * 0.80f - offset, screen_height * 0.50f - offset}};
+
+    // bottom-right
+    numbers[i++] = (MatrixNumber){matrix.small_bottom_right, {screen_width * 0.71f - offset, screen_height * 0.71f - offset}};
+
+    // bottom
+    numbers[i++] = (MatrixNumber){matrix.small_bottom, {center.x - offset, screen_height * 0.80f - offset}};
+
+    // bottom-left
+    numbers[i++] = (MatrixNumber){matrix.small_bottom_left, {screen_width * 0.29f - offset, screen_height * 0.71f - offset}};
+
+    // money
+    numbers[i++] = (MatrixNumber){matrix.money, {screen_width * 0.73f - offset, screen_height * 0.57f - offset}};
 
-    Text male_text = {font, {330, 300}, {0, 0}, 44.0f, 15.0f, 2.0f, BLACK};
-    DrawTextPro(male_text.font, "male generation line", male_text.position, male_text.origin, male_text.rotation, male_text.font_size, male_text.spacing, male_text.color);
+    // center-bottom
+    numbers[i++] = (MatrixNumber){matrix.center_bottom, {screen_width * 0.65f - offset, screen_height * 0.65f - offset}};
+
+    // love
+    numbers[i++] = (MatrixNumber){matrix.love, {screen_width * 0.57f - offset, screen_height * 0.73f - offset}};
+
+    // center-right
+    numbers[i++] = (MatrixNumber){matrix.center_right, {screen_width * 0.57f - offset, screen_height * 0.50f - offset}};
 }
 
 void draw_number(Font font, DateOfBirth dob) {
     if (dob.is_valid) {
         DestinyMatrix matrix = calculate_destiny_matrix(dob);
+        MatrixNumber numbers[MATRIX_NUMBER_COUNT];
         char number_str[10];
 
-        int offset = 8;
-        
         int screen_width = GetScreenWidth();
         int screen_height = GetScreenHeight();
-        Vector2 center = {screen_width / 2.0f, screen_height / 2.0f};
-
-        // central number
-        sprintf(number_str, "%d", matrix.center);
-        Vector2 center_pos = {center.x - offset, center.y - offset};
-        DrawTextEx(font, number_str, center_pos, 24, 2, BLACK);
-
-        // -----------------------------------------------------
-        // 8 BIG
-        // left
-        sprintf(number_str, "%d", matrix.big_left);
-        Vector2 big_left_pos = {screen_width * 0.07f - offset, screen_height * 0.50f - offset};
-        DrawTextEx(font, number_str, big_left_pos, 24, 2, BLACK);
-
-        // top-left
-        sprintf(number_str, "%d", matrix.big_top_left);
-        Vector2 big_top_left_pos = {screen_width * 0.18f + 10.0f - offset, screen_height * 0.20f - 10.0f - offset};
-        DrawTextEx(font, number_str, big_top_left_pos, 24, 2, BLACK);
-
-        // top
-        sprintf(number_str, "%d", matrix.big_top);
-        Vector2 big_top_pos = {center.x - offset, screen_height * 0.07f - offset};
-        DrawTextEx(font, number_str, big_top_pos, 24, 2, BLACK);
-
-        // top-right
-        sprintf(number_str, "%d", matrix.big_top_right);
-        Vector2 big_top_right_pos = {screen_width * 0.80f + 10.0f - offset, screen_height * 0.20f - 10.0f - offset};
-        DrawTextEx(font, number_str, big_top_right_pos, 24, 2, BLACK);
-
-        // right
-        sprintf(number_str, "%d", matrix.big_right);
-        Vector2 big_right_pos = {screen_width * 0.93f + 2.0f - offset, screen_height * 0.50f - offset};
-        DrawTextEx(font, number_str, big_right_pos, 24, 2, BLACK);
-
-        // bottom-right
-        sprintf(number_str, "%d", matrix.big_bottom_right);
-        Vector2 big_bottom_right_pos = {screen_width * 0.80f + 8.0f - offset, screen_height * 0.80f + 8.0f- offset};
-        DrawTextEx(font, number_str, big_bottom_right_pos, 24, 2, BLACK);
-
-        // bottom
-        sprintf(number_str, "%d", matrix.big_bottom);
-        Vector2 big_bottom_pos = {center.x - offset, screen_height * 0.93f - offset};
-        DrawTextEx(font, number_str, big_bottom_pos, 24, 2, BLACK);
-
-        // bottom-left
-        sprintf(number_str, "%d", matrix.big_bottom_left);
-        Vector2 big_bottom_left_pos = {screen_width * 0.20f - 8.0f - offset, screen_height * 0.80f + 8.0f - offset};
-        DrawTextEx(font, number_str, big_bottom_left_pos, 24, 2, BLACK);
-
-        // -----------------------------------------------------
-        // 8 MEDIUM
-        // left
-        sprintf(number_str, "%d", matrix.medium_left);
-        Vector2 medium_left_pos = {screen_width * 0.14f - offset, screen_height * 0.50f - offset};
-        DrawTextEx(font, number_str, medium_left_pos, 24, 2, BLACK);
-
-        // top-left
-        sprintf(number_str, "%d", matrix.medium_top_left);
-        Vector2 medium_top_left_pos = {screen_width * 0.24f + 3.0f - offset, screen_height * 0.26f - 15.0f - offset};
-        DrawTextEx(font, number_str, medium_top_left_pos, 24, 2, BLACK);
-
-        // top
-        sprintf(number_str, "%d", matrix.medium_top);
-        Vector2 medium_top_pos = {center.x - offset, screen_height * 0.14f - offset};
-        DrawTextEx(font, number_str, medium_top_pos, 24, 2, BLACK);
-
-        // top-right
-        sprintf(number_str, "%d", matrix.medium_top_right);
-        Vector2 medium_top_right_pos = {screen_width * 0.74f + 15.0f - offset, screen_height * 0.26f - 15.0f - offset};
-        DrawTextEx(font, number_str, medium_top_right_pos, 24, 2, BLACK);
-
-        // right
-        sprintf(number_str, "%d", matrix.medium_right);
-        Vector2 medium_right_pos = {screen_width * 0.86f - offset, screen_height * 0.50f - offset};
-        DrawTextEx(font, number_str, medium_right_pos, 24, 2, BLACK);
-
-        // bottom-right
-        sprintf(number_str, "%d", matrix.medium_bottom_right);
-        Vector2 medium_bottom_right_pos = {screen_width * 0.75f + 4.0f - offset, screen_height * 0.75f + 4.0f - offset};
-        DrawTextEx(font, number_str, medium_bottom_right_pos, 24, 2, BLACK);
-
-        // bottom
-        sprintf(number_str, "%d", matrix.medium_bottom);
-        Vector2 medium_bottom_pos = {center.x - offset, screen_height * 0.86f - offset};
-        DrawTextEx(font, number_str, medium_bottom_pos, 24, 2, BLACK);
-
-        // bottom-left
-        sprintf(number_str, "%d", matrix.medium_bottom_left);
-        Vector2 medium_bottom_left_pos = {screen_width * 0.25f - 4.0f - offset, screen_height * 0.75f + 4.0f - offset};
-        DrawTextEx(font, number_str, medium_bottom_left_pos, 24, 2, BLACK);
-
-        // -----------------------------------------------------
-        // 8 SMALL
-        // left
-        sprintf(number_str, "%d", matrix.small_left);
-        Vector2 small_left_pos = {screen_width * 0.20f - offset, screen_height * 0.50f - offset};
-        DrawTextEx(font, number_str, small_left_pos, 24, 2, BLACK);
-
-        // top-left
-        sprintf(number_str, "%d", matrix.small_top_left);
-        Vector2 small_top_left_pos = {screen_width * 0.29f - offset, screen_height * 0.29f - 5.0f - offset};
-        DrawTextEx(font, number_str, small_top_left_pos, 24, 2, BLACK);
-
-        // top
-        sprintf(number_str, "%d", matrix.small_top);
-        Vector2 small_top_pos = {center.x - offset, screen_height * 0.20f - offset};
-        DrawTextEx(font, number_str, small_top_pos, 24, 2, BLACK);
-
-        // top-right
-        sprintf(number_str, "%d", matrix.small_top_right);
-        Vector2 small_top_right_pos = {screen_width * 0.71f - offset, screen_height * 0.29f - 5.0f - offset};
-        DrawTextEx(font, number_str, small_top_right_pos, 24, 2, BLACK);
-
-        // right
-        sprintf(number_str, "%d", matrix.small_right);
-        Vector2 small_right_pos = {screen_width * 0.80f - offset, screen_height * 0.50f - offset};
-        DrawTextEx(font, number_str, small_right_pos, 24, 2, BLACK);
-
-        // bottom-right
-        sprintf(number_str, "%d", matrix.small_bottom_right);
-        Vector2 small_bottom_right_pos = {screen_width * 0.71f - offset, screen_height * 0.71f - offset};
-        DrawTextEx(font, number_str, small_bottom_right_pos, 24, 2, BLACK);
-
-        // bottom
-        sprintf(number_str, "%d", matrix.small_bottom);
-        Vector2 small_bottom_pos = {center.x - offset, screen_height * 0.80f - offset};
-        DrawTextEx(font, number_str, small_bottom_pos, 24, 2, BLACK);
-
-        // bottom-left
-        sprintf(number_str, "%d", matrix.small_bottom_left);
-        Vector2 small_bottom_left_pos = {screen_width * 0.29f - offset, screen_height * 0.71f - offset};
-        DrawTextEx(font, number_str, small_bottom_left_pos, 24, 2, BLACK);
-
-        // money
-        sprintf(number_str, "%d", matrix.money);
-        Vector2 money_pos = {screen_width * 0.73f - offset, screen_height * 0.57f - offset};
-        DrawTextEx(font, number_str, money_pos, 24, 2, BLACK);
-
-        // center-bottom
-        sprintf(number_str, "%d", matrix.center_bottom);
-        Vector2 center_bottom_pos = {screen_width * 0.65f - offset, screen_height * 0.65f - offset};
-        DrawTextEx(font, number_str, center_bottom_pos, 24, 2, BLACK);
-
-        // love
-        sprintf(number_str, "%d", matrix.love);
-        Vector2 love_pos = {screen_width * 0.57f - offset, screen_height * 0.73f - offset};
-        DrawTextEx(font, number_str, love_pos, 24, 2, BLACK);
-
-        // center-right
-        sprintf(number_str, "%d", matrix.center_right);
-        Vector2 center_right_pos = {screen_width * 0.57f - offset, screen_height * 0.50f - offset};
-        DrawTextEx(font, number_str, center_right_pos, 24, 2, BLACK);
+        get_matrix_numbers(matrix, screen_width, screen_height, numbers);
+
+        for (int i = 0; i < MATRIX_NUMBER_COUNT; i++) {
+            sprintf(number_str, "%d", numbers[i].value);
+            DrawTextEx(font, number_str, numbers[i].position, NUMBER_FONT_SIZE, TEXT_SPACING, BLACK);
+        }
+    }
+}
 
+void draw_date(Font font, DateOfBirth dob) {
+    if (dob.is_valid) {
+        int screen_width = GetScreenWidth();
+        int screen_height = GetScreenHeight();
 
         // date informations
         char date_str[50];
         sprintf(date_str, "%02d/%02d/%04d", dob.day, dob.month, dob.year);
-        Vector2 date_size = MeasureTextEx(font, date_str, 20, 2);
-        DrawTextEx(font, date_str, (Vector2){screen_width * 0.09f - date_size.x/2, screen_height * 0.90f}, 20, 2, DARKGRAY);
+        Vector2 date_size = MeasureTextEx(font, date_str, DATE_FONT_SIZE, TEXT_SPACING);
+        DrawTextEx(font, date_str, (Vector2){screen_width * 0.09f - date_size.x/2, screen_height * 0.90f}, DATE_FONT_SIZE, TEXT_SPACING, DARKGRAY);
     }
 }
 
-void render_matrix(Vector2 center, Font font, DateOfBirth dob) {
+// everything but the date, this is all a matrix thumbnail shows
+void render_matrix_diagram(Vector2 center, Font font, DateOfBirth dob) {
     draw_matrix_octagon(center);
     draw_matrix_rhombus(center, RHOMBUS_WIDTH, RHOMBUS_HEIGHT, BLACK);
     draw_matrix_square(center);
     draw_matrix_core_circle(center);
     draw_matrix_lines(center);
-    draw_dashed_line(p1, p2, 10.0f, 5.0f, 2.0f, RED);
+    draw_dashed_line(p1, p2, DASH_LENGTH, DASH_GAP, DASH_THICKNESS, RED);
     draw_matrix_circles(center);
     draw_text(font);
     draw_number(font, dob);
 }
 
-void render_input_form(Font font, InputField* day_field, InputField* month_field, InputField* year_field, 
-                      bool show_result, const char* result_text, Color result_color) {
-    // background
-    DrawRectangle(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT, Fade(WHITE, 0.9f));
-    
+void render_matrix(Vector2 center, Font font, DateOfBirth dob) {
+    render_matrix_diagram(center, font, dob);
+    draw_date(font, dob);
+}
+
+// colors blend as usual but alpha accumulates, so a render texture cleared to an opaque
+// color stays opaque and anti-aliased edges aren't blended with the background a second time
+void begin_opaque_blend_mode(void) {
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+}
+
+// retained-mode input form: everything is painted once into a render texture,
+// afterwards only widgets whose text, focus, hover or caret changed are repainted
+void init_input_form(InputForm* form, Font font, InputField* day_field, InputField* month_field, InputField* year_field) {
+    memset(form, 0, sizeof(*form));
+    form->target = LoadRenderTexture(WINDOW_WIDTH, WINDOW_HEIGHT);
+    form->background = ColorAlphaBlend(LIGHTGRAY, Fade(WHITE, 0.9f), WHITE);
+
     // title
     const char* title = "ENTER YOUR DATE OF BIRTH";
     Vector2 title_size = MeasureTextEx(font, title, 30, 2);
-    DrawTextEx(font, title, 
-              (Vector2){WINDOW_WIDTH/2 - title_size.x/2, 150}, 
-              30, 2, DARKBLUE);
-    
+    form->labels[0] = (FormLabel){title, {WINDOW_WIDTH/2 - title_size.x/2, 150}, 30, DARKBLUE};
+
     // labels
-    DrawTextEx(font, "Day", (Vector2){350, 250}, 20, 2, DARKGRAY);
-    DrawTextEx(font, "Month", (Vector2){450, 250}, 20, 2, DARKGRAY);
-    DrawTextEx(font, "Year", (Vector2){550, 250}, 20, 2, DARKGRAY);
-    
-    // input fields
-    draw_input_field(day_field, font, "DD");
-    draw_input_field(month_field, font, "MM");
-    draw_input_field(year_field, font, "YYYY");
-    
+    form->labels[1] = (FormLabel){"Day", {350, 250}, 20, DARKGRAY};
+    form->labels[2] = (FormLabel){"Month", {450, 250}, 20, DARKGRAY};
+    form->labels[3] = (FormLabel){"Year", {550, 250}, 20, DARKGRAY};
+
     // separators
-    DrawTextEx(font, "/", (Vector2){435, 290}, 25, 2, DARKGRAY);
-    DrawTextEx(font, "/", (Vector2){535, 290}, 25, 2, DARKGRAY);
-    
+    form->labels[4] = (FormLabel){"/", {435, 290}, 25, DARKGRAY};
+    form->labels[5] = (FormLabel){"/", {535, 290}, 25, DARKGRAY};
+
     // instructions
     const char* instructions[] = {
         "Enter your date of birth to generate the Destiny Matrix",
         "Press ENTER to continue",
         "Press ESC to reset"
     };
-    
+
     for (int i = 0; i < 3; i++) {
         Vector2 instr_size = MeasureTextEx(font, instructions[i], 16, 2);
-        DrawTextEx(font, instructions[i], 
-                  (Vector2){WINDOW_WIDTH/2 - instr_size.x/2, 400 + i * 25}, 
-                  16, 2, GRAY);
+        form->labels[6 + i] = (FormLabel){instructions[i], {WINDOW_WIDTH/2 - instr_size.x/2, 400 + i * 25}, 16, GRAY};
     }
-    
-    // result
-    if (show_result) {
-        Vector2 result_size = MeasureTextEx(font, result_text, 20, 2);
-        DrawTextEx(font, result_text, 
-                  (Vector2){WINDOW_WIDTH/2 - result_size.x/2, 500}, 
-                  20, 2, result_color);
+    form->labels_dirty = true;
+
+    // input fields
+    InputField* fields[FORM_INPUT_COUNT] = {day_field, month_field, year_field};
+    const char* placeholders[FORM_INPUT_COUNT] = {"DD", "MM", "YYYY"};
+    for (int i = 0; i < FORM_INPUT_COUNT; i++) {
+        form->inputs[i].field = fields[i];
+        form->inputs[i].placeholder = placeholders[i];
+        form->inputs[i].dirty = true;
     }
+
+    // result, repainted as a full-width strip since its width changes with the text
+    form->result.bounds = (Rectangle){0, 500, WINDOW_WIDTH, 30};
+    form->result.dirty = true;
 }
 
-int main(void) {
-    InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Destiny Matrix");
-    SetExitKey(0);
-    SetTargetFPS(60);
-    Vector2 center = { GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f };
+void unload_input_form(InputForm* form) {
+    UnloadRenderTexture(form->target);
+}
 
-    Font font = LoadFont("./font/Roboto/Roboto-Italic-VariableFont_wdth,wght.ttf");
+void update_input_form(InputForm* form, Font font, double time, bool show_result, const char* result_text, Color result_color) {
+    form->stats = (FormStats){0, 0};
+
+    for (int i = 0; i < FORM_INPUT_COUNT; i++) {
+        FormInput* input = &form->inputs[i];
+        InputField* field = input->field;
+        bool caret_visible = field->active && (((time * 2) - (int)(time * 2)) > 0.5f);
 
-    AppState current_state = STATE_INPUT_FORM;
-    DateOfBirth user_dob = {0, 0, 0, false};
+        if (strcmp(input->drawn_text, field->text) != 0) {
+            strcpy(input->drawn_text, field->text);
+            input->text_width = MeasureTextEx(font, field->text, 20, 2).x;
+            form->stats.measure_calls++;
+            input->dirty = true;
+        }
+        if (input->drawn_mouse_on_text != field->mouse_on_text || input->drawn_active != field->active ||
+            input->drawn_caret != caret_visible) {
+            input->drawn_mouse_on_text = field->mouse_on_text;
+            input->drawn_active = field->active;
+            input->drawn_caret = caret_visible;
+            input->dirty = true;
+        }
+    }
 
-    InputField day_field, month_field, year_field;
-    init_input_field(&day_field, (Rectangle){350, 280, INPUT_FIELD_WIDTH, INPUT_FIELD_HEIGHT}, 2);
-    init_input_field(&month_field, (Rectangle){450, 280, INPUT_FIELD_WIDTH, INPUT_FIELD_HEIGHT}, 2);
-    init_input_field(&year_field, (Rectangle){550, 280, 100, INPUT_FIELD_HEIGHT}, 4);
+    FormResult* result = &form->result;
+    if (result->visible != show_result) {
+        result->visible = show_result;
+        result->dirty = true;
+    }
+    if (show_result && (strcmp(result->text, result_text) != 0 || ColorToInt(result->color) != ColorToInt(result_color))) {
+        snprintf(result->text, sizeof(result->text), "%s", result_text);
+        result->color = result_color;
+        Vector2 result_size = MeasureTextEx(font, result->text, 20, 2);
+        form->stats.measure_calls++;
+        result->position = (Vector2){WINDOW_WIDTH/2 - result_size.x/2, 500};
+        result->dirty = true;
+    }
+}
 
-    bool show_result = false;
-    char result_text[100] = "";
-    Color result_color = GREEN;
+void redraw_input_form(InputForm* form, Font font) {
+    bool any_dirty = form->labels_dirty || form->result.dirty;
+    for (int i = 0; i < FORM_INPUT_COUNT; i++) {
+        any_dirty = any_dirty || form->inputs[i].dirty;
+    }
+    if (!any_dirty) return;
 
-    while (!WindowShouldClose()) {
-        if (current_state == STATE_INPUT_FORM) {
-            update_input_field(&day_field);
-            update_input_field(&month_field);
-            update_input_field(&year_field);
-
-            if (IsKeyPressed(KEY_ENTER)) {
-                int day = atoi(day_field.text);
-                int month = atoi(month_field.text);
-                int year = atoi(year_field.text);
-
-                if (strlen(day_field.text) > 0 && strlen(month_field.text) > 0 && strlen(year_field.text) > 0) {
-                    if (is_valid_date(day, month, year)) {
-                        user_dob.day = day;
-                        user_dob.month = month;
-                        user_dob.year = year;
-                        user_dob.is_valid = true;
-                        current_state = STATE_MATRIX_VIEW;
-                        show_result = false;
-                    } else {
-                        sprintf(result_text, "Error: Insert a valid date!");
-                        result_color = RED;
-                        show_result = true;
-                    }
-                } else {
-                    sprintf(result_text, "You need to fill all fields!");
-                    result_color = ORANGE;
-                    show_result = true;
-                }
-            }
+    BeginTextureMode(form->target);
+        begin_opaque_blend_mode();
 
-            if (IsKeyPressed(KEY_ESCAPE)) {
-                strcpy(day_field.text, "");
-                strcpy(month_field.text, "");
-                strcpy(year_field.text, "");
-                day_field.letter_count = 0;
-                month_field.letter_count = 0;
-                year_field.letter_count = 0;
-                show_result = false;
-            }
-        } else if (current_state == STATE_MATRIX_VIEW) {
-            if (IsKeyPressed(KEY_ESCAPE)) {
-                current_state = STATE_INPUT_FORM;
+        if (form->labels_dirty) {
+            // background
+            ClearBackground(form->background);
+            form->stats.draw_calls++;
+
+            for (int i = 0; i < FORM_LABEL_COUNT; i++) {
+                FormLabel* label = &form->labels[i];
+                DrawTextEx(font, label->text, label->position, label->font_size, 2, label->color);
+                form->stats.draw_calls++;
             }
+            form->labels_dirty = false;
         }
 
+        for (int i = 0; i < FORM_INPUT_COUNT; i++) {
+            FormInput* input = &form->inputs[i];
+            if (!input->dirty) continue;
 
-        BeginDrawing();
-            if (current_state == STATE_MATRIX_VIEW) {
-                ClearBackground(WHITE);
-                render_matrix(center, font, user_dob);
+            // the box covers the whole widget, no need to clear behind it
+            form->stats.draw_calls += draw_input_field(input->field, font, input->placeholder, input->drawn_caret, input->text_width);
+            input->dirty = false;
+        }
 
-                DrawTextEx(font, "Press ESC to insert a new date", (Vector2){20, WINDOW_HEIGHT - 30}, 16, 2, DARKGRAY);
-            } else {
-                ClearBackground(LIGHTGRAY);
-                render_input_form(font, &day_field, &month_field, &year_field, show_result, result_text, result_color);
+        FormResult* result = &form->result;
+        if (result->dirty) {
+            DrawRectangleRec(result->bounds, form->background);
+            form->stats.draw_calls++;
+            if (result->visible) {
+                DrawTextEx(font, result->text, result->position, 20, 2, result->color);
+                form->stats.draw_calls++;
             }
-        EndDrawing();
+            result->dirty = false;
+        }
+
+        EndBlendMode();
+    EndTextureMode();
+}
+
+void draw_input_form(InputForm* form) {
+    // render textures are stored upside down
+    Rectangle source = {0, 0, (float)form->target.texture.width, -(float)form->target.texture.height};
+    DrawTextureRec(form->target.texture, source, (Vector2){0, 0}, WHITE);
+    form->stats.draw_calls++;
+
+    form->totals.draw_calls += form->stats.draw_calls;
+    form->totals.measure_calls += form->stats.measure_calls;
+    form->frames++;
+}
+
+//----------------------------------------
+
+// vector export (svg / pdf), no GL context needed
+typedef enum {
+    EXPORT_FORMAT_SVG,
+    EXPORT_FORMAT_PDF
+} ExportFormat;
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    bool failed;
+} ExportBuffer;
+
+// the static layer (everything but the numbers and the date) is written once
+// into static_layer, every document copies it and appends only the dynamic part
+typedef struct {
+    ExportFormat format;
+    ExportBuffer static_layer;
+    ExportBuffer output;
+    size_t pdf_object_offsets[5];
+    size_t pdf_stream_start;
+} MatrixExporter;
+
+bool export_buffer_reserve(ExportBuffer* buffer, size_t extra) {
+    if (buffer->failed) return false;
+    if (buffer->length + extra <= buffer->capacity) return true;
+
+    size_t capacity = (buffer->capacity > 0) ? buffer->capacity : 4096;
+    while (capacity < buffer->length + extra) capacity *= 2;
+
+    char* data = realloc(buffer->data, capacity);
+    if (data == NULL) {
+        buffer->failed = true;
+        return false;
     }
-    CloseWindow();
-    return 0;
-}
\ No newline at end of file
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+void export_buffer_append(ExportBuffer* buffer, const char* data, size_t length) {
+    if (!export_buffer_reserve(buffer, length)) return;
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+}
+
+void export_buffer_printf(ExportBuffer* buffer, const char* format, ...) {
+    if (buffer->failed) return;
+
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer->data + buffer->length, buffer->capacity - buffer->length, format, args);
+    va_end(args);
+
+    if (written < 0) {
+        buffer->failed = true;
+        return;
+    }
+
+    if (buffer->length + (size_t)written >= buffer->capacity) {
+        // didn't fit (or no storage yet), grow and format again
+        if (!export_buffer_reserve(buffer, (size_t)written + 1)) return;
+        va_start(args, format);
+        vsnprintf(buffer->data + buffer->length, buffer->capacity - buffer->length, format, args);
+        va_end(args);
+    }
+    buffer->length += (size_t)written;
+}
+
+void free_export_buffer(ExportBuffer* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+    buffer->failed = false;
+}
+
+// raylib draws text from its top-left corner, svg and pdf from the baseline
+Vector2 text_baseline(Vector2 position, float rotation, float font_size) {
+    float angle = rotation * DEG2RAD;
+    float ascent = font_size * EXPORT_TEXT_ASCENT;
+    return (Vector2){position.x - sinf(angle) * ascent, position.y + cosf(angle) * ascent};
+}
+
+void svg_color(ExportBuffer* buffer, Color color) {
+    export_buffer_printf(buffer, "#%02x%02x%02x", color.r, color.g, color.b);
+}
+
+void svg_text(ExportBuffer* buffer, const char* text, Vector2 position, float rotation, float font_size, Color color) {
+    // unrotated baseline, the transform below rotates it around the top-left corner like DrawTextPro
+    Vector2 baseline = text_baseline(position, 0.0f, font_size);
+
+    export_buffer_printf(buffer, "<text x=\"%.2f\" y=\"%.2f\" font-size=\"%.0f\" fill=\"", baseline.x, baseline.y, font_size);
+    svg_color(buffer, color);
+    export_buffer_printf(buffer, "\"");
+    if (rotation != 0.0f) {
+        export_buffer_printf(buffer, " transform=\"rotate(%.2f %.2f %.2f)\"", rotation, position.x, position.y);
+    }
+    export_buffer_printf(buffer, ">%s</text>\n", text);
+}
+
+void svg_ringed_circle(ExportBuffer* buffer, RingedCircle circle) {
+    export_buffer_printf(buffer, "<circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\" fill=\"#ffffff\"/>\n",
+                         circle.position.x, circle.position.y, circle.radius);
+    export_buffer_printf(buffer, "<circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\" fill=\"none\" stroke-width=\"%.2f\" stroke=\"",
+                         circle.position.x, circle.position.y,
+                         (circle.inner_radius + circle.outer_radius) / 2, circle.outer_radius - circle.inner_radius);
+    svg_color(buffer, circle.ring_color);
+    export_buffer_printf(buffer, "\"/>\n");
+}
+
+void write_svg_static_layer(ExportBuffer* buffer, Vector2 center, float screen_width, float screen_height) {
+    export_buffer_printf(buffer,
+        "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%.0f\" height=\"%.0f\" viewBox=\"0 0 %.0f %.0f\">\n",
+        screen_width, screen_height, screen_width, screen_height);
+    export_buffer_printf(buffer, "<rect width=\"100%%\" height=\"100%%\" fill=\"#ffffff\"/>\n");
+    export_buffer_printf(buffer, "<g font-family=\"Roboto, sans-serif\" font-style=\"italic\" letter-spacing=\"%.0f\">\n", TEXT_SPACING);
+
+    // octagon, raylib draws the outline inside the radius
+    float octagon_radius = OCTAGON_RADIUS - OCTAGON_THICKNESS / 2;
+    export_buffer_printf(buffer, "<polygon fill=\"none\" stroke=\"#000000\" stroke-width=\"%.2f\" points=\"", OCTAGON_THICKNESS);
+    for (int i = 0; i < OCTAGON_SIDES; i++) {
+        float angle = (OCTAGON_ROTATION + i * 360.0f / OCTAGON_SIDES) * DEG2RAD;
+        export_buffer_printf(buffer, "%s%.2f,%.2f", (i > 0) ? " " : "",
+                             center.x + cosf(angle) * octagon_radius, center.y + sinf(angle) * octagon_radius);
+    }
+    export_buffer_printf(buffer, "\"/>\n");
+
+    // rhombus
+    export_buffer_printf(buffer, "<polygon fill=\"none\" stroke=\"#000000\" stroke-width=\"%.2f\" points=\"%.2f,%.2f %.2f,%.2f %.2f,%.2f %.2f,%.2f\"/>\n",
+                         RHOMBUS_THICKNESS,
+                         center.x, center.y - RHOMBUS_HEIGHT / 2, center.x + RHOMBUS_WIDTH / 2, center.y,
+                         center.x, center.y + RHOMBUS_HEIGHT / 2, center.x - RHOMBUS_WIDTH / 2, center.y);
+
+    // square, also drawn inside its rectangle
+    export_buffer_printf(buffer, "<rect x=\"%.2f\" y=\"%.2f\" width=\"%.2f\" height=\"%.2f\" fill=\"none\" stroke=\"#000000\" stroke-width=\"%.2f\"/>\n",
+                         center.x - 300 + RECTANGLE_THICKNESS / 2, center.y - 300 + RECTANGLE_THICKNESS / 2,
+                         RECTANGLE_WIDTH - RECTANGLE_THICKNESS, RECTANGLE_HEIGHT - RECTANGLE_THICKNESS, RECTANGLE_THICKNESS);
+
+    // core circle
+    export_buffer_printf(buffer, "<circle cx=\"%.2f\" cy=\"%.2f\" r=\"%.2f\" fill=\"none\" stroke=\"#000000\" stroke-width=\"%.2f\"/>\n",
+                         center.x, center.y, (inner_radius_core_circle + outer_radius_core_circle) / 2,
+                         outer_radius_core_circle - inner_radius_core_circle);
+
+    // lines
+    MatrixLine lines[MATRIX_LINE_COUNT];
+    get_matrix_lines(center, screen_width, screen_height, lines);
+    for (int i = 0; i < MATRIX_LINE_COUNT; i++) {
+        export_buffer_printf(buffer, "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke-width=\"%.2f\" stroke=\"",
+                             center.x, center.y, lines[i].end.x, lines[i].end.y, MATRIX_LINE_THICKNESS);
+        svg_color(buffer, lines[i].color);
+        export_buffer_printf(buffer, "\"/>\n");
+    }
+
+    // dashed line
+    export_buffer_printf(buffer, "<line x1=\"%.2f\" y1=\"%.2f\" x2=\"%.2f\" y2=\"%.2f\" stroke-width=\"%.2f\" stroke-dasharray=\"%.0f %.0f\" stroke=\"",
+                         p1.x, p1.y, p2.x, p2.y, DASH_THICKNESS, DASH_LENGTH, DASH_GAP);
+    svg_color(buffer, RED);
+    export_buffer_printf(buffer, "\"/>\n");
+
+    // circles
+    RingedCircle circles[MATRIX_CIRCLE_COUNT];
+    get_matrix_circles(center, screen_width, screen_height, circles);
+    for (int i = 0; i < MATRIX_CIRCLE_COUNT; i++) {
+        svg_ringed_circle(buffer, circles[i]);
+    }
+
+    // generation lines text
+    for (int i = 0; i < MATRIX_LABEL_COUNT; i++) {
+        svg_text(buffer, matrix_labels[i].text, matrix_labels[i].position, matrix_labels[i].rotation, LABEL_FONT_SIZE, BLACK);
+    }
+}
+
+void write_svg_numbers(ExportBuffer* buffer, DateOfBirth dob, float screen_width, float screen_height) {
+    MatrixNumber numbers[MATRIX_NUMBER_COUNT];
+    get_matrix_numbers(calculate_destiny_matrix(dob), screen_width, screen_height, numbers);
+
+    char number_str[10];
+    for (int i = 0; i < MATRIX_NUMBER_COUNT; i++) {
+        sprintf(number_str, "%d", numbers[i].value);
+        svg_text(buffer, number_str, numbers[i].position, 0.0f, NUMBER_FONT_SIZE, BLACK);
+    }
+
+    // date informations, centered on the same point draw_number measures around
+    Vector2 date_pos = text_baseline((Vector2){screen_width * 0.09f, screen_height * 0.90f}, 0.0f, DATE_FONT_SIZE);
+    export_buffer_printf(buffer, "<text x=\"%.2f\" y=\"%.2f\" font-size=\"%.0f\" text-anchor=\"middle\" fill=\"",
+                         date_pos.x, date_pos.y, DATE_FONT_SIZE);
+    svg_color(buffer, DARKGRAY);
+    export_buffer_printf(buffer, "\">%02d/%02d/%04d</text>\n", dob.day, dob.month, dob.year);
+
+    export_buffer_printf(buffer, "</g>\n</svg>\n");
+}
+
+void pdf_stroke_color(ExportBuffer* buffer, Color color) {
+    export_buffer_printf(buffer, "%.3f %.3f %.3f RG\n", color.r / 255.0f, color.g / 255.0f, color.b / 255.0f);
+}
+
+void pdf_fill_color(ExportBuffer* buffer, Color color) {
+    export_buffer_printf(buffer, "%.3f %.3f %.3f rg\n", color.r / 255.0f, color.g / 255.0f, color.b / 255.0f);
+}
+
+// four bezier quarter arcs, closed, without the paint operator
+void pdf_circle_path(ExportBuffer* buffer, Vector2 center, float radius) {
+    const float k = 0.5523f * radius;
+    float x = center.x;
+    float y = center.y;
+
+    export_buffer_printf(buffer, "%.2f %.2f m\n", x + radius, y);
+    export_buffer_printf(buffer, "%.2f %.2f %.2f %.2f %.2f %.2f c\n", x + radius, y + k, x + k, y + radius, x, y + radius);
+    export_buffer_printf(buffer, "%.2f %.2f %.2f %.2f %.2f %.2f c\n", x - k, y + radius, x - radius, y + k, x - radius, y);
+    export_buffer_printf(buffer, "%.2f %.2f %.2f %.2f %.2f %.2f c\n", x - radius, y - k, x - k, y - radius, x, y - radius);
+    export_buffer_printf(buffer, "%.2f %.2f %.2f %.2f %.2f %.2f c h\n", x + k, y - radius, x + radius, y - k, x + radius, y);
+}
+
+// the page is flipped to raylib's top-left origin, so the text matrix flips the glyphs back
+void pdf_text(ExportBuffer* buffer, const char* text, Vector2 position, float rotation, float font_size, Color color) {
+    float angle = rotation * DEG2RAD;
+    Vector2 baseline = text_baseline(position, rotation, font_size);
+
+    pdf_fill_color(buffer, color);
+    export_buffer_printf(buffer, "BT /F1 %.0f Tf %.0f Tc %.4f %.4f %.4f %.4f %.2f %.2f Tm (%s) Tj ET\n",
+                         font_size, TEXT_SPACING, cosf(angle), sinf(angle), sinf(angle), -cosf(angle),
+                         baseline.x, baseline.y, text);
+}
+
+void write_pdf_static_layer(ExportBuffer* buffer, Vector2 center, float screen_width, float screen_height) {
+    export_buffer_printf(buffer, "1 0 0 -1 0 %.0f cm\n", screen_height);
+
+    // octagon
+    float octagon_radius = OCTAGON_RADIUS - OCTAGON_THICKNESS / 2;
+    pdf_stroke_color(buffer, BLACK);
+    export_buffer_printf(buffer, "%.2f w\n", OCTAGON_THICKNESS);
+    for (int i = 0; i < OCTAGON_SIDES; i++) {
+        float angle = (OCTAGON_ROTATION + i * 360.0f / OCTAGON_SIDES) * DEG2RAD;
+        export_buffer_printf(buffer, "%.2f %.2f %s\n",
+                             center.x + cosf(angle) * octagon_radius, center.y + sinf(angle) * octagon_radius,
+                             (i == 0) ? "m" : "l");
+    }
+    export_buffer_printf(buffer, "h S\n");
+
+    // rhombus
+    export_buffer_printf(buffer, "%.2f w\n%.2f %.2f m %.2f %.2f l %.2f %.2f l %.2f %.2f l h S\n",
+                         RHOMBUS_THICKNESS,
+                         center.x, center.y - RHOMBUS_HEIGHT / 2, center.x + RHOMBUS_WIDTH / 2, center.y,
+                         center.x, center.y + RHOMBUS_HEIGHT / 2, center.x - RHOMBUS_WIDTH / 2, center.y);
+
+    // square
+    export_buffer_printf(buffer, "%.2f w\n%.2f %.2f %.2f %.2f re S\n",
+                         RECTANGLE_THICKNESS,
+                         center.x - 300 + RECTANGLE_THICKNESS / 2, center.y - 300 + RECTANGLE_THICKNESS / 2,
+                         RECTANGLE_WIDTH - RECTANGLE_THICKNESS, RECTANGLE_HEIGHT - RECTANGLE_THICKNESS);
+
+    // core circle
+    export_buffer_printf(buffer, "%.2f w\n", outer_radius_core_circle - inner_radius_core_circle);
+    pdf_circle_path(buffer, center, (inner_radius_core_circle + outer_radius_core_circle) / 2);
+    export_buffer_printf(buffer, "S\n");
+
+    // lines
+    MatrixLine lines[MATRIX_LINE_COUNT];
+    get_matrix_lines(center, screen_width, screen_height, lines);
+    export_buffer_printf(buffer, "%.2f w\n", MATRIX_LINE_THICKNESS);
+    for (int i = 0; i < MATRIX_LINE_COUNT; i++) {
+        pdf_stroke_color(buffer, lines[i].color);
+        export_buffer_printf(buffer, "%.2f %.2f m %.2f %.2f l S\n", center.x, center.y, lines[i].end.x, lines[i].end.y);
+    }
+
+    // dashed line
+    pdf_stroke_color(buffer, RED);
+    export_buffer_printf(buffer, "%.2f w [%.0f %.0f] 0 d\n%.2f %.2f m %.2f %.2f l S\n[] 0 d\n",
+                         DASH_THICKNESS, DASH_LENGTH, DASH_GAP, p1.x, p1.y, p2.x, p2.y);
+
+    // circles
+    RingedCircle circles[MATRIX_CIRCLE_COUNT];
+    get_matrix_circles(center, screen_width, screen_height, circles);
+    pdf_fill_color(buffer, WHITE);
+    for (int i = 0; i < MATRIX_CIRCLE_COUNT; i++) {
+        pdf_circle_path(buffer, circles[i].position, circles[i].radius);
+        export_buffer_printf(buffer, "f\n");
+
+        pdf_stroke_color(buffer, circles[i].ring_color);
+        export_buffer_printf(buffer, "%.2f w\n", circles[i].outer_radius - circles[i].inner_radius);
+        pdf_circle_path(buffer, circles[i].position, (circles[i].inner_radius + circles[i].outer_radius) / 2);
+        export_buffer_printf(buffer, "S\n");
+    }
+
+    // generation lines text
+    for (int i = 0; i < MATRIX_LABEL_COUNT; i++) {
+        pdf_text(buffer, matrix_labels[i].text, matrix_labels[i].position, matrix_labels[i].rotation, LABEL_FONT_SIZE, BLACK);
+    }
+}
+
+void write_pdf_numbers(ExportBuffer* buffer, DateOfBirth dob, float screen_width, float screen_height) {
+    MatrixNumber numbers[MATRIX_NUMBER_COUNT];
+    get_matrix_numbers(calculate_destiny_matrix(dob), screen_width, screen_height, numbers);
+
+    char number_str[10];
+    for (int i = 0; i < MATRIX_NUMBER_COUNT; i++) {
+        sprintf(number_str, "%d", numbers[i].value);
+        pdf_text(buffer, number_str, numbers[i].position, 0.0f, NUMBER_FONT_SIZE, BLACK);
+    }
+
+    // date informations, there are no font metrics here so the width is estimated
+    char date_str[50];
+    sprintf(date_str, "%02d/%02d/%04d", dob.day, dob.month, dob.year);
+    float date_width = strlen(date_str) * (DATE_FONT_SIZE * 0.55f + TEXT_SPACING);
+    pdf_text(buffer, date_str, (Vector2){screen_width * 0.09f - date_width/2, screen_height * 0.90f}, 0.0f, DATE_FONT_SIZE, DARKGRAY);
+}
+
+void init_matrix_exporter(MatrixExporter* exporter, ExportFormat format) {
+    memset(exporter, 0, sizeof(*exporter));
+    exporter->format = format;
+
+    ExportBuffer* layer = &exporter->static_layer;
+    Vector2 center = {WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f};
+
+    if (format == EXPORT_FORMAT_SVG) {
+        write_svg_static_layer(layer, center, WINDOW_WIDTH, WINDOW_HEIGHT);
+        return;
+    }
+
+    // pdf: every object up to the content stream is the same for each document
+    export_buffer_printf(layer, "%%PDF-1.4\n%%\xE2\xE3\xCF\xD3\n");
+    exporter->pdf_object_offsets[0] = layer->length;
+    export_buffer_printf(layer, "1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+    exporter->pdf_object_offsets[1] = layer->length;
+    export_buffer_printf(layer, "2 0 obj\n<< /Type /Pages /Kids [3 0 R] /Count 1 >>\nendobj\n");
+    exporter->pdf_object_offsets[2] = layer->length;
+    export_buffer_printf(layer, "3 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 %d %d] "
+                                "/Resources << /Font << /F1 4 0 R >> >> /Contents 5 0 R >>\nendobj\n",
+                         WINDOW_WIDTH, WINDOW_HEIGHT);
+    exporter->pdf_object_offsets[3] = layer->length;
+    export_buffer_printf(layer, "4 0 obj\n<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica-Oblique >>\nendobj\n");
+    exporter->pdf_object_offsets[4] = layer->length;
+    export_buffer_printf(layer, "5 0 obj\n<< /Length 6 0 R >>\nstream\n");
+    exporter->pdf_stream_start = layer->length;
+
+    write_pdf_static_layer(layer, center, WINDOW_WIDTH, WINDOW_HEIGHT);
+}
+
+void unload_matrix_exporter(MatrixExporter* exporter) {
+    free_export_buffer(&exporter->static_layer);
+    free_export_buffer(&exporter->output);
+}
+
+// writes the document into exporter->output, reusing its storage between calls
+const ExportBuffer* export_matrix(MatrixExporter* exporter, DateOfBirth dob) {
+    ExportBuffer* output = &exporter->output;
+    output->length = 0;
+    export_buffer_append(output, exporter->static_layer.data, exporter->static_layer.length);
+
+    if (exporter->format == EXPORT_FORMAT_SVG) {
+        write_svg_numbers(output, dob, WINDOW_WIDTH, WINDOW_HEIGHT);
+    } else {
+        write_pdf_numbers(output, dob, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+        size_t stream_length = output->length - exporter->pdf_stream_start;
+        export_buffer_printf(output, "\nendstream\nendobj\n");
+        size_t length_offset = output->length;
+        export_buffer_printf(output, "6 0 obj\n%zu\nendobj\n", stream_length);
+
+        size_t xref_offset = output->length;
+        export_buffer_printf(output, "xref\n0 7\n0000000000 65535 f \n");
+        for (int i = 0; i < 5; i++) {
+            export_buffer_printf(output, "%010zu 00000 n \n", exporter->pdf_object_offsets[i]);
+        }
+        export_buffer_printf(output, "%010zu 00000 n \n", length_offset);
+        export_buffer_printf(output, "trailer\n<< /Size 7 /Root 1 0 R >>\nstartxref\n%zu\n%%%%EOF\n", xref_offset);
+    }
+
+    if (output->failed || exporter->static_layer.failed) return NULL;
+    return output;
+}
+
+bool parse_date(const char* text, DateOfBirth* dob) {
+    int day, month, year;
+    if (sscanf(text, "%d/%d/%d", &day, &month, &year) != 3) return false;
+    if (!is_valid_date(day, month, year)) return false;
+
+    *dob = (DateOfBirth){day, month, year, true};
+    return true;
+}
+
+// destiny_matrix --svg|--pdf DD/MM/YYYY [output], writes to stdout without an output path
+int run_export(int argc, char** argv) {
+    ExportFormat format = (strcmp(argv[1], "--pdf") == 0) ? EXPORT_FORMAT_PDF : EXPORT_FORMAT_SVG;
+
+    DateOfBirth dob;
+    if (argc < 3 || !parse_date(argv[2], &dob)) {
+        fprintf(stderr, "Usage: %s %s DD/MM/YYYY [output]\n", argv[0], argv[1]);
+        return 1;
+    }
+
+    MatrixExporter exporter;
+    init_matrix_exporter(&exporter, format);
+    const ExportBuffer* document = export_matrix(&exporter, dob);
+    if (document == NULL) {
+        fprintf(stderr, "Error: out of memory while exporting\n");
+        unload_matrix_exporter(&exporter);
+        return 1;
+    }
+
+    FILE* file = (argc > 3) ? fopen(argv[3], "wb") : stdout;
+    if (file == NULL) {
+        fprintf(stderr, "Error: cannot open %s\n", argv[3]);
+        unload_matrix_exporter(&exporter);
+        return 1;
+    }
+
+    bool written = fwrite(document->data, 1, document->length, file) == document->length;
+    // buffered data only reaches the disk on close/flush, so those failures count too
+    if (file != stdout) written = (fclose(file) == 0) && written;
+    else written = (fflush(stdout) == 0) && written;
+    unload_matrix_exporter(&exporter);
+
+    if (!written) fprintf(stderr, "Error: cannot write %s\n", (argc > 3) ? argv[3] : "to stdout");
+    return written ? 0 : 1;
+}
+
+//----------------------------------------
+
+// matrix thumbnail atlas
+// a matrix only depends on the reduced day, the month and the reduced year digit sum,
+// so every date maps to one of MATRIX_KEY_COUNT keys and each key is rendered once
+int matrix_key_from_numbers(int day_number, int month_number, int year_number) {
+    return ((day_number - 1) * 12 + (month_number - 1)) * 22 + (year_number - 1);
+}
+
+int matrix_key(DestinyMatrix matrix) {
+    return matrix_key_from_numbers(matrix.big_left, matrix.big_top, matrix.big_right);
+}
+
+void fnv1a(unsigned int* hash, const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        *hash ^= bytes[i];
+        *hash *= 16777619u;
+    }
+}
+
+// changes whenever a layout constant or position that shows up in a thumbnail changes
+unsigned int matrix_layout_hash(void) {
+    unsigned int hash = 2166136261u;
+    Vector2 center = {WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f};
+
+    const float constants[] = {
+        WINDOW_WIDTH, WINDOW_HEIGHT,
+        OCTAGON_SIDES, OCTAGON_RADIUS, OCTAGON_ROTATION, OCTAGON_THICKNESS,
+        RHOMBUS_WIDTH, RHOMBUS_HEIGHT, RHOMBUS_THICKNESS,
+        RECTANGLE_THICKNESS, RECTANGLE_WIDTH, RECTANGLE_HEIGHT,
+        inner_radius_core_circle, outer_radius_core_circle,
+        MATRIX_LINE_THICKNESS, DASH_LENGTH, DASH_GAP, DASH_THICKNESS, p1.x, p1.y, p2.x, p2.y,
+        TEXT_SPACING, LABEL_FONT_SIZE, NUMBER_FONT_SIZE,
+        THUMBNAIL_SIZE, ATLAS_PAGE_SIZE, ATLAS_VERSION
+    };
+    fnv1a(&hash, constants, sizeof(constants));
+
+    RingedCircle circles[MATRIX_CIRCLE_COUNT];
+    get_matrix_circles(center, WINDOW_WIDTH, WINDOW_HEIGHT, circles);
+    fnv1a(&hash, circles, sizeof(circles));
+
+    MatrixLine lines[MATRIX_LINE_COUNT];
+    get_matrix_lines(center, WINDOW_WIDTH, WINDOW_HEIGHT, lines);
+    fnv1a(&hash, lines, sizeof(lines));
+
+    for (int i = 0; i < MATRIX_LABEL_COUNT; i++) {
+        fnv1a(&hash, matrix_labels[i].text, strlen(matrix_labels[i].text));
+        fnv1a(&hash, &matrix_labels[i].position, sizeof(Vector2));
+        fnv1a(&hash, &matrix_labels[i].rotation, sizeof(float));
+    }
+
+    MatrixNumber numbers[MATRIX_NUMBER_COUNT];
+    get_matrix_numbers((DestinyMatrix){0}, WINDOW_WIDTH, WINDOW_HEIGHT, numbers);
+    fnv1a(&hash, numbers, sizeof(numbers));
+
+    return hash;
+}
+
+// index file: header, then the atlas slot of every matrix key (-1 when no date maps to it)
+bool load_matrix_atlas(MatrixAtlas* atlas, const char* directory) {
+    memset(atlas, 0, sizeof(*atlas));
+    snprintf(atlas->directory, sizeof(atlas->directory), "%s", directory);
+
+    char path[300];
+    snprintf(path, sizeof(path), "%s/" ATLAS_INDEX_FILE, directory);
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+
+    AtlasHeader header;
+    bool loaded = fread(&header, sizeof(header), 1, file) == 1 &&
+                  memcmp(header.magic, ATLAS_MAGIC, 4) == 0 &&
+                  header.layout_hash == matrix_layout_hash() &&
+                  header.page_count <= ATLAS_MAX_PAGES &&
+                  fread(atlas->slots, sizeof(atlas->slots), 1, file) == 1;
+    fclose(file);
+
+    atlas->page_count = loaded ? (int)header.page_count : 0;
+
+    // an index without all of its pages (at their full size) is as good as no index
+    for (int i = 0; i < atlas->page_count && loaded; i++) {
+        snprintf(path, sizeof(path), "%s/" ATLAS_PAGE_FILE, directory, i);
+        FILE* page = fopen(path, "rb");
+        loaded = page != NULL && fseek(page, 0, SEEK_END) == 0 && ftell(page) == ATLAS_PAGE_BYTES;
+        if (page != NULL) fclose(page);
+    }
+    return loaded;
+}
+
+// needs a window the size of WINDOW_WIDTH x WINDOW_HEIGHT, the draw functions read the screen size
+bool build_matrix_atlas(MatrixAtlas* atlas, const char* directory, Font font) {
+    memset(atlas, 0, sizeof(*atlas));
+    snprintf(atlas->directory, sizeof(atlas->directory), "%s", directory);
+    mkdir(directory, 0755);
+
+    // one representative date per distinct matrix
+    static DateOfBirth representatives[MATRIX_KEY_COUNT];
+    int thumbnail_count = 0;
+    for (int i = 0; i < MATRIX_KEY_COUNT; i++) atlas->slots[i] = -1;
+
+    for (int year = 1900; year <= 2025; year++) {
+        for (int month = 1; month <= 12; month++) {
+            for (int day = 1; day <= 31 && is_valid_date(day, month, year); day++) {
+                DateOfBirth dob = {day, month, year, true};
+                int key = matrix_key(calculate_destiny_matrix(dob));
+                if (atlas->slots[key] >= 0) continue;
+
+                atlas->slots[key] = (short)thumbnail_count;
+                representatives[thumbnail_count++] = dob;
+            }
+        }
+    }
+    atlas->page_count = (thumbnail_count + ATLAS_THUMBNAILS_PER_PAGE - 1) / ATLAS_THUMBNAILS_PER_PAGE;
+
+    // full size render, then downscaled through mipmaps into the page
+    RenderTexture2D full = LoadRenderTexture(WINDOW_WIDTH, WINDOW_HEIGHT);
+    RenderTexture2D page = LoadRenderTexture(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+    Vector2 center = {WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f};
+    bool saved = true;
+
+    for (int p = 0; p < atlas->page_count && saved; p++) {
+        BeginTextureMode(page);
+            ClearBackground(WHITE);
+        EndTextureMode();
+
+        for (int i = 0; i < ATLAS_THUMBNAILS_PER_PAGE; i++) {
+            int slot = p * ATLAS_THUMBNAILS_PER_PAGE + i;
+            if (slot >= thumbnail_count) break;
+
+            BeginTextureMode(full);
+                ClearBackground(WHITE);
+                begin_opaque_blend_mode();
+                render_matrix_diagram(center, font, representatives[slot]);
+                EndBlendMode();
+            EndTextureMode();
+            GenTextureMipmaps(&full.texture);
+            SetTextureFilter(full.texture, TEXTURE_FILTER_TRILINEAR);
+
+            Rectangle source = {0, 0, WINDOW_WIDTH, -WINDOW_HEIGHT};
+            Rectangle dest = {(float)((i % ATLAS_COLUMNS) * THUMBNAIL_SIZE), (float)((i / ATLAS_COLUMNS) * THUMBNAIL_SIZE), THUMBNAIL_SIZE, THUMBNAIL_SIZE};
+            BeginTextureMode(page);
+                begin_opaque_blend_mode();
+                DrawTexturePro(full.texture, source, dest, (Vector2){0, 0}, 0.0f, WHITE);
+                EndBlendMode();
+            EndTextureMode();
+        }
+
+        Image image = LoadImageFromTexture(page.texture);
+        ImageFlipVertical(&image);
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8);
+
+        char path[300];
+        snprintf(path, sizeof(path), "%s/" ATLAS_PAGE_FILE, directory, p);
+        FILE* file = fopen(path, "wb");
+        saved = file != NULL && fwrite(image.data, 1, ATLAS_PAGE_BYTES, file) == (size_t)ATLAS_PAGE_BYTES;
+        if (file != NULL) saved = (fclose(file) == 0) && saved;
+        UnloadImage(image);
+    }
+    UnloadRenderTexture(full);
+    UnloadRenderTexture(page);
+    if (!saved) return false;
+
+    // the index goes last, so an interrupted build is never picked up
+    char path[300];
+    snprintf(path, sizeof(path), "%s/" ATLAS_INDEX_FILE, directory);
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    AtlasHeader header = {{0}, matrix_layout_hash(), (unsigned int)atlas->page_count};
+    memcpy(header.magic, ATLAS_MAGIC, 4);
+    saved = fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(atlas->slots, sizeof(atlas->slots), 1, file) == 1;
+    return (fclose(file) == 0) && saved;
+}
+
+// reads the tile of the date's matrix straight out of its raw page file, one row at a time
+bool copy_matrix_thumbnail(MatrixAtlas* atlas, DateOfBirth dob, Image* thumbnail) {
+    int slot = atlas->slots[matrix_key(calculate_destiny_matrix(dob))];
+    if (slot < 0) return false;
+
+    int page = slot / ATLAS_THUMBNAILS_PER_PAGE;
+    int i = slot % ATLAS_THUMBNAILS_PER_PAGE;
+    if (page >= atlas->page_count) return false;
+
+    char path[300];
+    snprintf(path, sizeof(path), "%s/" ATLAS_PAGE_FILE, atlas->directory, page);
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return false;
+
+    const int row_bytes = THUMBNAIL_SIZE * 3;
+    unsigned char* data = MemAlloc(row_bytes * THUMBNAIL_SIZE);
+    long x = (i % ATLAS_COLUMNS) * THUMBNAIL_SIZE;
+    long y = (i / ATLAS_COLUMNS) * THUMBNAIL_SIZE;
+    bool copied = data != NULL;
+
+    for (int row = 0; row < THUMBNAIL_SIZE && copied; row++) {
+        copied = fseek(file, (y + row) * ATLAS_PAGE_STRIDE + x * 3, SEEK_SET) == 0 &&
+                 fread(data + row * row_bytes, 1, row_bytes, file) == (size_t)row_bytes;
+    }
+    fclose(file);
+
+    if (!copied) {
+        MemFree(data);
+        return false;
+    }
+    *thumbnail = (Image){data, THUMBNAIL_SIZE, THUMBNAIL_SIZE, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8};
+    return true;
+}
+
+// opens a hidden window just for the build, only called when the cache is missing or stale
+bool build_matrix_atlas_headless(MatrixAtlas* atlas, const char* directory) {
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Destiny Matrix");
+    if (!IsWindowReady()) {
+        fprintf(stderr, "Error: cannot create a window to render the atlas, a display (or Xvfb) is required\n");
+        return false;
+    }
+    Font font = LoadFont("./font/Roboto/Roboto-Italic-VariableFont_wdth,wght.ttf");
+
+    bool built = build_matrix_atlas(atlas, directory, font);
+
+    UnloadFont(font);
+    CloseWindow();
+    return built;
+}
+
+// destiny_matrix --build-atlas
+// destiny_matrix --thumbnail DD/MM/YYYY output.png
+int run_atlas(int argc, char** argv) {
+    static MatrixAtlas atlas;
+    bool build_only = strcmp(argv[1], "--build-atlas") == 0;
+
+    DateOfBirth dob;
+    if (!build_only && (argc < 4 || !parse_date(argv[2], &dob))) {
+        fprintf(stderr, "Usage: %s --thumbnail DD/MM/YYYY output.png\n", argv[0]);
+        return 1;
+    }
+
+    bool rebuilt = build_only || !load_matrix_atlas(&atlas, ATLAS_DIRECTORY);
+    if (rebuilt && !build_matrix_atlas_headless(&atlas, ATLAS_DIRECTORY)) {
+        fprintf(stderr, "Error: cannot build the atlas in %s\n", ATLAS_DIRECTORY);
+        return 1;
+    }
+    if (build_only) {
+        printf("%d atlas pages written to %s\n", atlas.page_count, ATLAS_DIRECTORY);
+        return 0;
+    }
+
+    // every valid date has a slot, so a failed copy means an unreadable page: rebuild once and retry
+    Image thumbnail;
+    bool copied = copy_matrix_thumbnail(&atlas, dob, &thumbnail);
+    if (!copied && !rebuilt && build_matrix_atlas_headless(&atlas, ATLAS_DIRECTORY)) {
+        copied = copy_matrix_thumbnail(&atlas, dob, &thumbnail);
+    }
+    if (!copied) {
+        fprintf(stderr, "Error: no thumbnail for %s\n", argv[2]);
+        return 1;
+    }
+
+    bool written = ExportImage(thumbnail, argv[3]);
+    UnloadImage(thumbnail);
+    return written ? 0 : 1;
+}
+
+//----------------------------------------
+
+// partial-date queries
+// unknown components are swept in batches: dates only matter through the reduced
+// day and year numbers, so a month contributes a histogram of reduced days and an
+// unknown year a histogram of reduced year sums, split by leap years for february
+void init_date_query_tables(DateQueryTables* tables) {
+    memset(tables, 0, sizeof(*tables));
+
+    for (int length = 28; length <= 31; length++) {
+        for (int day = 1; day <= length; day++) {
+            tables->day_counts[length][reduce_to_destiny_number(day)]++;
+        }
+    }
+
+    for (int year = 1900; year <= 2025; year++) {
+        tables->year_counts[is_leap_year(year)][reduce_to_destiny_number(year_digit_sum(year))]++;
+    }
+
+    for (int day = 1; day <= 22; day++) {
+        for (int month = 1; month <= 12; month++) {
+            for (int year = 1; year <= 22; year++) {
+                DestinyMatrix matrix = calculate_destiny_matrix_from_numbers(day, month, year);
+                tables->matrices[matrix_key(matrix)] = matrix;
+            }
+        }
+    }
+}
+
+// accepts "DD/MM/YYYY" where any component may be "?", "??", "????" or "*"
+bool parse_partial_date(const char* text, PartialDate* date) {
+    const int max_digits[3] = {2, 2, 4};
+    int values[3] = {0, 0, 0};
+    const char* part = text;
+
+    for (int i = 0; i < 3; i++) {
+        const char* end = (i < 2) ? strchr(part, '/') : part + strlen(part);
+        if (end == NULL || end == part || end - part > max_digits[i]) return false;
+
+        if (part[0] == '?' || part[0] == '*') {
+            for (const char* c = part; c < end; c++) {
+                if (*c != '?' && *c != '*') return false;
+            }
+        } else {
+            for (const char* c = part; c < end; c++) {
+                if (*c < '0' || *c > '9') return false;
+            }
+            values[i] = atoi(part);
+            if (values[i] == 0) return false;
+        }
+        part = end + 1;
+    }
+
+    *date = (PartialDate){values[0], values[1], values[2]};
+    if (date->day > 31 || date->month > 12) return false;
+    if (date->year != 0 && (date->year < 1900 || date->year > 2025)) return false;
+    return true;
+}
+
+// counts every full date consistent with the partial one per matrix key,
+// result->total stays 0 when there is none (e.g. 30/02/????)
+void run_date_query(const DateQueryTables* tables, PartialDate date, DateQueryResult* result) {
+    // only the keys touched by the previous query are cleared
+    for (int i = 0; i < result->distinct; i++) {
+        result->counts[result->keys[i]] = 0;
+    }
+    result->distinct = 0;
+    result->total = 0;
+
+    int first_month = (date.month != 0) ? date.month : 1;
+    int last_month = (date.month != 0) ? date.month : 12;
+
+    for (int month = first_month; month <= last_month; month++) {
+        for (int leap = 0; leap <= 1; leap++) {
+            int year_weights[23] = {0};
+            if (date.year != 0) {
+                if (is_leap_year(date.year) != leap) continue;
+                year_weights[reduce_to_destiny_number(year_digit_sum(date.year))] = 1;
+            } else {
+                memcpy(year_weights, tables->year_counts[leap], sizeof(year_weights));
+            }
+
+            int length = days_in_month(month, leap);
+            int day_weights[23] = {0};
+            if (date.day != 0) {
+                if (date.day > length) continue;
+                day_weights[reduce_to_destiny_number(date.day)] = 1;
+            } else {
+                memcpy(day_weights, tables->day_counts[length], sizeof(day_weights));
+            }
+
+            // iterate only the reduced numbers that occur
+            int years[22];
+            int year_count = 0;
+            for (int year = 1; year <= 22; year++) {
+                if (year_weights[year] != 0) years[year_count++] = year;
+            }
+
+            for (int day = 1; day <= 22; day++) {
+                if (day_weights[day] == 0) continue;
+                for (int j = 0; j < year_count; j++) {
+                    int year = years[j];
+                    int key = matrix_key_from_numbers(day, month, year);
+                    long count = (long)day_weights[day] * year_weights[year];
+                    if (result->counts[key] == 0) result->keys[result->distinct++] = key;
+                    result->counts[key] += count;
+                    result->total += count;
+                }
+            }
+        }
+    }
+}
+
+// value distribution of one DestinyMatrix field over the query result
+void date_query_distribution(const DateQueryTables* tables, const DateQueryResult* result, int field, long distribution[23]) {
+    memset(distribution, 0, 23 * sizeof(long));
+
+    for (int i = 0; i < result->distinct; i++) {
+        int key = result->keys[i];
+        distribution[matrix_field_value(&tables->matrices[key], field)] += result->counts[key];
+    }
+}
+
+// writes the decimal digits of a non-negative number, returns the end
+char* format_number(char* cursor, long number) {
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + number % 10);
+        number /= 10;
+    } while (number > 0);
+
+    while (count > 0) *cursor++ = digits[--count];
+    return cursor;
+}
+
+// one "<record>\t<dates>\t<distinct>" line per record, followed by every distinct
+// matrix as "<day number>/<month>/<year number>:<dates>", or "<record>\tinvalid"
+bool query_records(FILE* input, const DateQueryTables* tables, DateQueryResult* result) {
+    char line[64];
+    long invalid = 0;
+    ExportBuffer output = {0};
+
+    while (fgets(line, sizeof(line), input) != NULL) {
+        size_t length = strcspn(line, "\r\n");
+        bool complete = line[length] != '\0' || feof(input);
+        line[length] = '\0';
+
+        // an overlong record, skip the rest of the line
+        if (!complete) {
+            int c;
+            while ((c = fgetc(input)) != EOF && c != '\n') {}
+        }
+
+        PartialDate date;
+        bool matched = complete && parse_partial_date(line, &date);
+        if (matched) {
+            run_date_query(tables, date, result);
+            matched = result->total > 0;
+        }
+        if (!matched) {
+            printf("%s\tinvalid\n", line);
+            invalid++;
+            continue;
+        }
+
+        // printf per matrix dominates at millions of records, so the line is formatted by hand
+        output.length = 0;
+        export_buffer_printf(&output, "%s\t%ld\t%d\t", line, result->total, result->distinct);
+        if (!export_buffer_reserve(&output, (size_t)result->distinct * 32 + 1)) break;
+
+        char* cursor = output.data + output.length;
+        for (int i = 0; i < result->distinct; i++) {
+            const DestinyMatrix* matrix = &tables->matrices[result->keys[i]];
+            if (i > 0) *cursor++ = ' ';
+            cursor = format_number(cursor, matrix->big_left);
+            *cursor++ = '/';
+            cursor = format_number(cursor, matrix->big_top);
+            *cursor++ = '/';
+            cursor = format_number(cursor, matrix->big_right);
+            *cursor++ = ':';
+            cursor = format_number(cursor, result->counts[result->keys[i]]);
+        }
+        *cursor++ = '\n';
+        fwrite(output.data, 1, cursor - output.data, stdout);
+    }
+    bool formatted = !output.failed;
+    free_export_buffer(&output);
+
+    if (invalid > 0) fprintf(stderr, "%ld records match no valid date\n", invalid);
+    return !ferror(input) && formatted && invalid == 0;
+}
+
+// destiny_matrix --query DD/MM/YYYY..., unknown components as "?"
+// destiny_matrix --query-file records.txt, one partial date per line ("-" reads stdin)
+int run_query(int argc, char** argv) {
+    bool from_file = strcmp(argv[1], "--query-file") == 0;
+    if (argc < 3 || (from_file && argc != 3)) {
+        fprintf(stderr, "Usage: %s --query DD/MM/YYYY... | --query-file file (unknown components as ?)\n", argv[0]);
+        return 1;
+    }
+
+    static DateQueryTables tables;
+    static DateQueryResult result;
+    init_date_query_tables(&tables);
+
+    if (from_file) {
+        FILE* input = (strcmp(argv[2], "-") == 0) ? stdin : fopen(argv[2], "r");
+        if (input == NULL) {
+            fprintf(stderr, "Error: cannot read %s\n", argv[2]);
+            return 1;
+        }
+
+        bool ok = query_records(input, &tables, &result);
+        if (input != stdin) fclose(input);
+        return ok ? 0 : 1;
+    }
+
+    int status = 0;
+    for (int i = 2; i < argc; i++) {
+        PartialDate date;
+        bool matched = parse_partial_date(argv[i], &date);
+        if (matched) {
+            run_date_query(&tables, date, &result);
+            matched = result.total > 0;
+        }
+        if (!matched) {
+            fprintf(stderr, "Error: %s matches no valid date\n", argv[i]);
+            status = 1;
+            continue;
+        }
+
+        printf("%s: %ld dates, %d distinct matrices\n", argv[i], result.total, result.distinct);
+        for (int field = 0; field < MATRIX_FIELD_COUNT; field++) {
+            long distribution[23];
+            date_query_distribution(&tables, &result, field, distribution);
+
+            printf("  %-20s", matrix_fields[field].name);
+            for (int value = 1; value <= 22; value++) {
+                if (distribution[value] > 0) printf(" %d:%ld", value, distribution[value]);
+            }
+            printf("\n");
+        }
+    }
+    return status;
+}
+
+//----------------------------------------
+
+// app, shared by the live loop and the replay
+void init_app(App* app, Font font) {
+    app->font = font;
+    app->center = (Vector2){ GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f };
+    app->state = STATE_INPUT_FORM;
+    app->dob = (DateOfBirth){0, 0, 0, false};
+
+    init_input_field(&app->day_field, (Rectangle){350, 280, INPUT_FIELD_WIDTH, INPUT_FIELD_HEIGHT}, 2);
+    init_input_field(&app->month_field, (Rectangle){450, 280, INPUT_FIELD_WIDTH, INPUT_FIELD_HEIGHT}, 2);
+    init_input_field(&app->year_field, (Rectangle){550, 280, 100, INPUT_FIELD_HEIGHT}, 4);
+
+    app->show_result = false;
+    strcpy(app->result_text, "");
+    app->result_color = GREEN;
+
+    init_input_form(&app->form, font, &app->day_field, &app->month_field, &app->year_field);
+}
+
+void unload_app(App* app) {
+    unload_input_form(&app->form);
+}
+
+// must run outside BeginDrawing(), the form repaints its render texture here
+void update_app(App* app, FrameInput* input) {
+    if (app->state == STATE_INPUT_FORM) {
+        update_input_field(&app->day_field, input);
+        update_input_field(&app->month_field, input);
+        update_input_field(&app->year_field, input);
+
+        if (input->pressed & INPUT_KEY_ENTER) {
+            int day = atoi(app->day_field.text);
+            int month = atoi(app->month_field.text);
+            int year = atoi(app->year_field.text);
+
+            if (strlen(app->day_field.text) > 0 && strlen(app->month_field.text) > 0 && strlen(app->year_field.text) > 0) {
+                if (is_valid_date(day, month, year)) {
+                    app->dob.day = day;
+                    app->dob.month = month;
+                    app->dob.year = year;
+                    app->dob.is_valid = true;
+                    app->state = STATE_MATRIX_VIEW;
+                    app->show_result = false;
+                } else {
+                    sprintf(app->result_text, "Error: Insert a valid date!");
+                    app->result_color = RED;
+                    app->show_result = true;
+                }
+            } else {
+                sprintf(app->result_text, "You need to fill all fields!");
+                app->result_color = ORANGE;
+                app->show_result = true;
+            }
+        }
+
+        if (input->pressed & INPUT_KEY_ESCAPE) {
+            strcpy(app->day_field.text, "");
+            strcpy(app->month_field.text, "");
+            strcpy(app->year_field.text, "");
+            app->day_field.letter_count = 0;
+            app->month_field.letter_count = 0;
+            app->year_field.letter_count = 0;
+            app->show_result = false;
+        }
+    } else if (app->state == STATE_MATRIX_VIEW) {
+        if (input->pressed & INPUT_KEY_ESCAPE) {
+            app->state = STATE_INPUT_FORM;
+        }
+    }
+
+    if (app->state == STATE_INPUT_FORM) {
+        update_input_form(&app->form, app->font, input->time, app->show_result, app->result_text, app->result_color);
+        redraw_input_form(&app->form, app->font);
+    }
+}
+
+void draw_app(App* app) {
+    if (app->state == STATE_MATRIX_VIEW) {
+        ClearBackground(WHITE);
+        render_matrix(app->center, app->font, app->dob);
+
+        DrawTextEx(app->font, "Press ESC to insert a new date", (Vector2){20, WINDOW_HEIGHT - 30}, 16, 2, DARKGRAY);
+    } else {
+        ClearBackground(LIGHTGRAY);
+        draw_input_form(&app->form);
+    }
+}
+
+//----------------------------------------
+
+// input recording, one record per frame:
+// u8 pressed flags, i16 mouse x, i16 mouse y, u8 char count, then each char as a LEB128 varint
+bool open_input_recording(InputRecording* recording, const char* path, const char* mode) {
+    recording->file = fopen(path, mode);
+    recording->fps = RECORDING_FPS;
+    recording->frames = 0;
+    recording->failed = false;
+    if (recording->file == NULL) return false;
+
+    unsigned char header[6];
+    if (mode[0] == 'w') {
+        memcpy(header, RECORDING_MAGIC, 4);
+        header[4] = RECORDING_VERSION;
+        header[5] = RECORDING_FPS;
+        return fwrite(header, 1, sizeof(header), recording->file) == sizeof(header);
+    }
+
+    if (fread(header, 1, sizeof(header), recording->file) != sizeof(header) ||
+        memcmp(header, RECORDING_MAGIC, 4) != 0 || header[4] != RECORDING_VERSION || header[5] == 0) {
+        fclose(recording->file);
+        recording->file = NULL;
+        return false;
+    }
+    recording->fps = header[5];
+    return true;
+}
+
+// returns false when a write failed, e.g. on a full disk, and the recording is truncated
+bool close_input_recording(InputRecording* recording) {
+    if (recording->file != NULL && fclose(recording->file) != 0) recording->failed = true;
+    recording->file = NULL;
+    return !recording->failed;
+}
+
+void write_input_frame(InputRecording* recording, const FrameInput* input) {
+    if (recording->failed) return;
+
+    unsigned char record[6 + MAX_FRAME_CHARS * 5];
+    int length = 0;
+
+    short mouse_x = (short)input->mouse_position.x;
+    short mouse_y = (short)input->mouse_position.y;
+    record[length++] = input->pressed;
+    record[length++] = (unsigned char)(mouse_x & 0xFF);
+    record[length++] = (unsigned char)((mouse_x >> 8) & 0xFF);
+    record[length++] = (unsigned char)(mouse_y & 0xFF);
+    record[length++] = (unsigned char)((mouse_y >> 8) & 0xFF);
+    record[length++] = (unsigned char)input->char_count;
+
+    for (int i = 0; i < input->char_count; i++) {
+        unsigned int codepoint = (unsigned int)input->chars[i];
+        do {
+            unsigned char byte = codepoint & 0x7F;
+            codepoint >>= 7;
+            record[length++] = byte | (codepoint ? 0x80 : 0);
+        } while (codepoint);
+    }
+
+    if (fwrite(record, 1, length, recording->file) != (size_t)length) {
+        recording->failed = true;
+        return;
+    }
+    recording->frames++;
+}
+
+// returns false at the end of the recording (or on a truncated record)
+bool read_input_frame(InputRecording* recording, FrameInput* input) {
+    unsigned char record[6];
+    if (fread(record, 1, sizeof(record), recording->file) != sizeof(record)) return false;
+
+    input->time = (double)recording->frames / recording->fps;
+    input->pressed = record[0];
+    input->mouse_position.x = (short)(record[1] | (record[2] << 8));
+    input->mouse_position.y = (short)(record[3] | (record[4] << 8));
+    input->char_count = (record[5] < MAX_FRAME_CHARS) ? record[5] : MAX_FRAME_CHARS;
+
+    for (int i = 0; i < record[5]; i++) {
+        unsigned int codepoint = 0;
+        int shift = 0;
+        int byte;
+        do {
+            byte = fgetc(recording->file);
+            if (byte == EOF || shift > 28) return false;
+            codepoint |= (unsigned int)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+
+        if (i < input->char_count) input->chars[i] = (int)codepoint;
+    }
+
+    recording->frames++;
+    return true;
+}
+
+//----------------------------------------
+
+// replay statistics
+int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// nearest-rank percentile, samples must be sorted
+double percentile(const double* samples, int count, double p) {
+    if (count == 0) return 0.0;
+    int rank = (int)ceil(p / 100.0 * count);
+    if (rank < 1) rank = 1;
+    return samples[rank - 1];
+}
+
+void add_frame_time(FrameTimes* times, double milliseconds) {
+    if (times->count == times->capacity) {
+        int capacity = (times->capacity > 0) ? times->capacity * 2 : 1024;
+        double* samples = realloc(times->samples, capacity * sizeof(double));
+        if (samples == NULL) return;
+        times->samples = samples;
+        times->capacity = capacity;
+    }
+    times->samples[times->count++] = milliseconds;
+}
+
+// baseline file: one "<state> <p50> <p90> <p99>" line per state, in milliseconds
+bool save_replay_baseline(const char* path, const ReplaySummary summary[APP_STATE_COUNT]) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) return false;
+
+    for (int i = 0; i < APP_STATE_COUNT; i++) {
+        if (summary[i].frames == 0) continue;
+        fprintf(file, "%s %.4f %.4f %.4f\n", app_state_names[i], summary[i].p50, summary[i].p90, summary[i].p99);
+    }
+    return fclose(file) == 0;
+}
+
+// returns the number of regressed states, or -1 when the baseline can't be read
+int compare_replay_baseline(const char* path, const ReplaySummary summary[APP_STATE_COUNT]) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return -1;
+
+    int regressions = 0;
+    char name[32];
+    double p50, p90, p99;
+    while (fscanf(file, "%31s %lf %lf %lf", name, &p50, &p90, &p99) == 4) {
+        for (int i = 0; i < APP_STATE_COUNT; i++) {
+            if (strcmp(name, app_state_names[i]) != 0 || summary[i].frames == 0) continue;
+
+            bool regressed = summary[i].p50 > p50 * (1.0 + REPLAY_TOLERANCE) ||
+                             summary[i].p90 > p90 * (1.0 + REPLAY_TOLERANCE);
+            printf("%-12s p50 %+6.1f%%  p90 %+6.1f%%  p99 %+6.1f%%  %s\n", name,
+                   (p50 > 0) ? (summary[i].p50 / p50 - 1.0) * 100.0 : 0.0,
+                   (p90 > 0) ? (summary[i].p90 / p90 - 1.0) * 100.0 : 0.0,
+                   (p99 > 0) ? (summary[i].p99 / p99 - 1.0) * 100.0 : 0.0,
+                   regressed ? "REGRESSION" : "ok");
+            if (regressed) regressions++;
+        }
+    }
+    fclose(file);
+    return regressions;
+}
+
+// destiny_matrix --replay input.dmir [--baseline file] [--save-baseline file]
+// runs at a fixed timestep in a hidden window, on mesa's software rasterizer unless told otherwise
+int run_replay(int argc, char** argv) {
+    const char* baseline_path = NULL;
+    const char* save_baseline_path = NULL;
+    bool valid_options = argc >= 3;
+    for (int i = 3; i < argc && valid_options; i += 2) {
+        if (i + 1 >= argc) valid_options = false;
+        else if (strcmp(argv[i], "--baseline") == 0) baseline_path = argv[i + 1];
+        else if (strcmp(argv[i], "--save-baseline") == 0) save_baseline_path = argv[i + 1];
+        else valid_options = false;
+    }
+
+    if (!valid_options) {
+        fprintf(stderr, "Usage: %s --replay input.dmir [--baseline file] [--save-baseline file]\n", argv[0]);
+        return 1;
+    }
+
+    InputRecording recording;
+    if (!open_input_recording(&recording, argv[2], "rb")) {
+        fprintf(stderr, "Error: cannot read %s\n", argv[2]);
+        return 1;
+    }
+
+    setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Destiny Matrix");
+    if (!IsWindowReady()) {
+        // no GL context without a display, e.g. on a CI runner without Xvfb
+        fprintf(stderr, "Error: cannot create the replay window, a display (or Xvfb) is required\n");
+        close_input_recording(&recording);
+        return 1;
+    }
+    SetExitKey(0);
+
+    Font font = LoadFont("./font/Roboto/Roboto-Italic-VariableFont_wdth,wght.ttf");
+    App app;
+    init_app(&app, font);
+
+    FrameTimes times[APP_STATE_COUNT] = {0};
+    FrameInput input;
+    while (read_input_frame(&recording, &input)) {
+        double start = GetTime();
+
+        update_app(&app, &input);
+        BeginDrawing();
+            draw_app(&app);
+        EndDrawing();
+
+        add_frame_time(&times[app.state], (GetTime() - start) * 1000.0);
+    }
+    close_input_recording(&recording);
+
+    ReplaySummary summary[APP_STATE_COUNT] = {0};
+    printf("%-12s %8s %9s %9s %9s %9s\n", "state", "frames", "p50 ms", "p90 ms", "p99 ms", "max ms");
+    for (int i = 0; i < APP_STATE_COUNT; i++) {
+        if (times[i].count == 0) continue;
+        qsort(times[i].samples, times[i].count, sizeof(double), compare_doubles);
+
+        summary[i].frames = times[i].count;
+        summary[i].p50 = percentile(times[i].samples, times[i].count, 50);
+        summary[i].p90 = percentile(times[i].samples, times[i].count, 90);
+        summary[i].p99 = percentile(times[i].samples, times[i].count, 99);
+        printf("%-12s %8d %9.3f %9.3f %9.3f %9.3f\n", app_state_names[i], summary[i].frames,
+               summary[i].p50, summary[i].p90, summary[i].p99, times[i].samples[times[i].count - 1]);
+        free(times[i].samples);
+    }
+
+    if (app.form.frames > 0) {
+        printf("form: %.2f draw calls, %.2f measure calls per frame\n",
+               (double)app.form.totals.draw_calls / app.form.frames, (double)app.form.totals.measure_calls / app.form.frames);
+    }
+
+    unload_app(&app);
+    UnloadFont(font);
+    CloseWindow();
+
+    if (save_baseline_path != NULL && !save_replay_baseline(save_baseline_path, summary)) {
+        fprintf(stderr, "Error: cannot write %s\n", save_baseline_path);
+        return 1;
+    }
+
+    if (baseline_path != NULL) {
+        int regressions = compare_replay_baseline(baseline_path, summary);
+        if (regressions < 0) {
+            fprintf(stderr, "Error: cannot read %s\n", baseline_path);
+            return 1;
+        }
+        if (regressions > 0) return 2;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && (strcmp(argv[1], "--svg") == 0 || strcmp(argv[1], "--pdf") == 0)) {
+        return run_export(argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "--replay") == 0) {
+        return run_replay(argc, argv);
+    }
+    if (argc > 1 && (strcmp(argv[1], "--build-atlas") == 0 || strcmp(argv[1], "--thumbnail") == 0)) {
+        return run_atlas(argc, argv);
+    }
+    if (argc > 1 && (strcmp(argv[1], "--query") == 0 || strcmp(argv[1], "--query-file") == 0)) {
+        return run_query(argc, argv);
+    }
+
+    // destiny_matrix --record input.dmir
+    InputRecording recording = {0};
+    if (argc > 1) {
+        if (argc != 3 || strcmp(argv[1], "--record") != 0) {
+            fprintf(stderr, "Usage: %s [--record input.dmir]\n", argv[0]);
+            return 1;
+        }
+        if (!open_input_recording(&recording, argv[2], "wb")) {
+            fprintf(stderr, "Error: cannot write %s\n", argv[2]);
+            return 1;
+        }
+    }
+
+    InitWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Destiny Matrix");
+    SetExitKey(0);
+    SetTargetFPS(RECORDING_FPS);
+
+    Font font = LoadFont("./font/Roboto/Roboto-Italic-VariableFont_wdth,wght.ttf");
+
+    App app;
+    init_app(&app, font);
+
+    while (!WindowShouldClose()) {
+        FrameInput input;
+        poll_frame_input(&input, GetTime());
+        if (recording.file != NULL) write_input_frame(&recording, &input);
+
+        update_app(&app, &input);
+
+        BeginDrawing();
+            draw_app(&app);
+        EndDrawing();
+    }
+
+    if (app.form.frames > 0) {
+        TraceLog(LOG_INFO, "FORM: %.2f draw calls, %.2f measure calls per frame over %ld frames",
+                 (double)app.form.totals.draw_calls / app.form.frames, (double)app.form.totals.measure_calls / app.form.frames, app.form.frames);
+    }
+    if (recording.file != NULL) {
+        if (close_input_recording(&recording)) {
+            TraceLog(LOG_INFO, "RECORD: %ld frames written to %s", recording.frames, argv[2]);
+        } else {
+            TraceLog(LOG_WARNING, "RECORD: writing %s failed, the recording is truncated", argv[2]);
+        }
+    }
+    unload_app(&app);
+    UnloadFont(font);
+    CloseWindow();
+    return 0;
+}